@@ -2,278 +2,817 @@
 
 #include "SparseArray.h"
 #include "SparseMatrix.h"
+#include "CompressedPattern.h"
 #include "Permutation.h"
+#include "PermutationSearch.h"
 #include "Normalization.h"
+#include "Factorization.h"
+#include "SupernodalMatrix.h"
+#include "SkylineMatrix.h"
+#include "EliminationTree.h"
 
 #include "misc/IntList.h"
+#include "misc/ThreadPool.h"
 
-#include <stack>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 namespace spandex
 {
-	template<class T>
+	template<class T, class I = int, class O = I>
 	class CholeskySolver
 	{
 	private:
-		misc::IntList list;
+		struct Links
+		{
+			std::vector<I> heads;
+			std::vector<I> links;
+			std::vector<O> nexts;
+			std::vector<bool> deferred;
 
-		SparseMatrix<T> ata;
-		SparseMatrix<T> ld;
-		std::vector<T> y;
+			void Reset(I n)
+			{
+				heads.assign(n, -1);
+				links.assign(n, -1);
+				nexts.assign(n, 0);
+				deferred.clear();
+			}
+
+			void Link(SparseMatrix<T, I, O>& ld, I r)
+			{
+				if (nexts[r] >= ld.columns[r + 1])
+				{
+					return;
+				}
+
+				I i = ld.columnsRows[nexts[r]];
+				if (!deferred.empty() && deferred[i])
+				{
+					return;
+				}
+
+				links[r] = heads[i];
+				heads[i] = r;
+			}
+
+			void Collect(I j, std::vector<I>& updates) const
+			{
+				updates.clear();
+				for (I r = heads[j]; -1 != r; r = links[r])
+				{
+					updates.push_back(r);
+				}
+				std::sort(updates.begin(), updates.end());
+			}
+
+			void Advance(SparseMatrix<T, I, O>& ld, I j)
+			{
+				for (I r = heads[j]; -1 != r;)
+				{
+					I following = links[r];
+					nexts[r] += 1;
+					Link(ld, r);
+					r = following;
+				}
+				heads[j] = -1;
 
-		Permutation perm;
+				nexts[j] = ld.columns[j] + 1;
+				Link(ld, j);
+			}
+		};
+
+		misc::BasicIntList<I> list;
+
+		SparseMatrix<T, I, O> ata;
+		SparseMatrix<T, I, O> ld;
+		BasicEliminationTree<I> tree;
+		SupernodalMatrix<T, I, O> supernodal;
+		SkylineMatrix<T, I, O> skyline;
+		CompressedPattern<I, O> compressed;
+		std::vector<T> y;
+		std::vector<T> acc;
+		std::vector<T> vals;
+		std::vector<T> work;
+		Links links;
+		std::vector<I> updates;
+
+		BasicPermutation<I> perm;
+		BasicPermutationSearch<I> search;
 		std::vector<T> norm;
 
+		std::unique_ptr<misc::ThreadPool> pool;
+		bool banded;
+
+		std::vector<I> lowerLevels;
+		std::vector<I> lowerLevelsRows;
+		std::vector<I> upperLevels;
+		std::vector<I> upperLevelsColumns;
+
+		std::vector<I> tasks;
+		std::vector<I> tasksNodes;
+		std::vector<I> top;
+		std::vector<std::vector<T>> threadAccs;
+		std::vector<std::vector<I>> threadUpdates;
+
 	public:
-		int rowCount;
-		int columnCount;
+		I rowCount;
+		I columnCount;
 		Permutation::Type permutation;
 		Normalization::Type normalization;
+		Factorization::Type factorization;
 		T tolerance;
-
-		CholeskySolver(int rowCount, int columnCount) : rowCount(rowCount), columnCount(columnCount),
+		int threadCount;
+		int parallelColumnSize;
+		int parallelSolveSize;
+		int parallelLevelSize;
+		int skylineWidth;
+		double skylineProfile;
+		int permutationSeeds;
+		double permutationBudget;
+		bool compactStorage;
+		bool compressedIndices;
+
+		CholeskySolver(I rowCount, I columnCount) : rowCount(rowCount), columnCount(columnCount),
 			list(columnCount)
 		{
 			permutation = Permutation::Type::NoPermutation;
 			normalization = Normalization::Type::NoNormalization;
+			factorization = Factorization::Type::LeftLooking;
 			tolerance = (T)1e-10;
+			threadCount = 1;
+			parallelColumnSize = 256;
+			parallelSolveSize = 4096;
+			parallelLevelSize = 64;
+			skylineWidth = 16;
+			skylineProfile = 1.25;
+			permutationSeeds = 3;
+			permutationBudget = 1.0;
+			compactStorage = false;
+			compressedIndices = false;
+			banded = false;
 		}
 
-		Permutation& GetPermutation()
+		BasicPermutation<I>& GetPermutation()
 		{
 			return perm;
 		}
 
-		void SolveSym(SparseMatrix<T>& a)
+		const BasicPermutationSearch<I>& GetPermutationSearch() const
 		{
-			perm = Permutation::Build(a, permutation);
-			ata = SparseMatrix<T>(std::move(SqrSym(a, perm)));
-			ld = SparseMatrix<T>(std::move(CholSym(ata)));
-			y.resize(a.columnCount);
+			return search;
 		}
 
-		std::vector<T> Solve(SparseMatrix<T>& a, std::vector<T>& b)
+		const SparseMatrix<T, I, O>& GetFactor() const
 		{
-			SqrTo(a, perm, ata);
+			return ld;
+		}
 
-			this->norm = Normalization::NormTo(normalization, ata);
+		void SolveSym(SparseMatrix<T, I, O>& a)
+		{
+			if (!a.HasRows())
+			{
+				a.BuildRows();
+			}
 
-			CholTo(ata, ld);
+			search = BasicPermutationSearch<I>();
+			if (Permutation::Type::Auto == permutation)
+			{
+				search = threadCount > 1 ?
+					BasicPermutationSearch<I>::Search(a, permutationSeeds, permutationBudget, perm, GetPool()) :
+					BasicPermutationSearch<I>::Search(a, permutationSeeds, permutationBudget, perm);
+			}
+			else
+			{
+				perm = threadCount > 1 ?
+					BasicPermutation<I>::Build(a, permutation, GetPool()) :
+					BasicPermutation<I>::Build(a, permutation);
+			}
+			tree = BasicEliminationTree<I>::BuildSqr(a, perm);
 
-			MulTo(a, b, y);
-			y = Permute(y, [&](int i) { return perm.GetPermuted(i); });
+			if (tree.GetNnz() > (long long)std::numeric_limits<O>::max())
+			{
+				throw std::overflow_error("factor nnz exceeds the offset type");
+			}
 
-			for (int i = 0; i < (int)y.size(); i++)
+			ld = SparseMatrix<T, I, O>(std::move(SqrCholSym(a, perm, tree)));
+			ata = SparseMatrix<T, I, O>();
+			supernodal = SupernodalMatrix<T, I, O>();
+			if (Factorization::Type::Supernodal == factorization)
+			{
+				supernodal = SupernodalMatrix<T, I, O>::FromPattern(ld);
+			}
+			skyline = SkylineMatrix<T, I, O>();
+			banded = IsBanded(ld);
+			if (IsSkyline())
+			{
+				skyline = SkylineMatrix<T, I, O>::FromPattern(ld);
+			}
+			if (compactStorage)
 			{
-				y[i] *= norm[i];
+				ld.DropRows();
 			}
+			compressed = CompressedPattern<I, O>();
+			if (compressedIndices)
+			{
+				compressed = CompressedPattern<I, O>::FromMatrix(ld);
+				ld.DropRows();
+				ReleaseRows();
+			}
+			lowerLevels.clear();
+			upperLevels.clear();
+			tasks.clear();
+
+			I n = a.columnCount;
+			y.assign(n, T());
+			acc.assign(n, T());
+			vals.assign(n, T());
+			work.assign(n, T());
+			norm.assign(n, (T)1);
+			links.Reset(n);
+			updates.reserve(n);
+		}
 
-			std::vector<T> x(ld.rowCount);
-			SolveTo(ld, y, x);
+		std::vector<T> Solve(SparseMatrix<T, I, O>& a, std::vector<T>& b)
+		{
+			std::vector<T> x(a.columnCount);
+			Solve(a, std::span<const T>(b), std::span<T>(x));
+
+			return std::move(x);
+		}
+
+		void Solve(SparseMatrix<T, I, O>& a, std::span<const T> b, std::span<T> x)
+		{
+			assert(a.rowCount == (I)b.size());
+			assert(a.columnCount == (I)x.size());
+
+			Factor(a);
+
+			for (I i = 0; i < a.columnCount; i++)
+			{
+				I ii = perm.GetPermuted(i);
+
+				T sum = (T)0;
+				for (O k = a.columns[ii]; k < a.columns[ii + 1]; k++)
+				{
+					sum += b[a.columnsRows[k]] * a.values[k];
+				}
+				y[i] = sum * norm[i];
+			}
+
+			SolveTo(x);
+		}
+
+		std::vector<T> Solve(SparseMatrix<T, I, O>& a, std::vector<T>& b, int k)
+		{
+			assert(k > 0);
+			assert((I)b.size() == a.rowCount * k);
+
+			Factor(a);
+
+			I n = ld.rowCount;
+
+			std::vector<T> c(n * k);
+			MulTo(a, b, c, k);
+
+			std::vector<T> yk(n * k);
+			for (I i = 0; i < n; i++)
+			{
+				I ii = perm.GetPermuted(i);
+				for (int t = 0; t < k; t++)
+				{
+					yk[i * k + t] = c[ii * k + t] * norm[i];
+				}
+			}
 
-			for (int i = 0; i < (int)x.size(); i++)
+			std::vector<T> z(n * k);
+			if (skyline.size == n)
+			{
+				skyline.SolveLowerTo(std::span<const T>(yk), std::span<T>(z), k);
+				skyline.SolveUpperTo(std::span<T>(z), k);
+			}
+			else if (compressed.size == n)
+			{
+				compressed.SolveLowerTo(ld, std::span<const T>(yk), std::span<T>(z), k);
+				compressed.SolveUpperTo(ld, std::span<T>(z), k);
+			}
+			else
 			{
-				x[i] *= norm[i];
+				z = SolveLower(ld, yk, k);
+				z = SolveDiag(ld, z, k);
+				z = SolveUpper(ld, z, k);
 			}
 
-			x = Permute(x, [&](int i) { return perm.GetPrimary(i); });
+			std::vector<T> x(n * k);
+			for (I i = 0; i < n; i++)
+			{
+				I ii = perm.GetPrimary(i);
+				for (int t = 0; t < k; t++)
+				{
+					x[i + t * n] = z[ii * k + t] * norm[ii];
+				}
+			}
 
 			return std::move(x);
 		}
 
 		std::vector<T> Update(SparseArray<T>& u, T v)
+		{
+			std::vector<T> x(ld.rowCount);
+			Update(u, v, std::span<T>(x));
+
+			return std::move(x);
+		}
+
+		void Update(const SparseArray<T>& u, T v, std::span<T> x)
 		{
 			assert(ld.rowCount == u.size);
+			assert(ld.rowCount == (I)x.size());
 
 			const T zero = (T)0;
 			for (auto it = u.begin(); it != u.end(); ++it)
 			{
 				if (zero != it->second)
 				{
-					int i = perm.GetPrimary(it->first);
+					I i = perm.GetPrimary(it->first);
 					y[i] += v * it->second * norm[i];
 				}
 			}
 
-			Update(ld, perm, u);
-
-			std::vector<T> x(ld.rowCount);
-			SolveTo(ld, y, x);
-
-			for (int i = 0; i < u.size; i++)
+			if (skyline.size == ld.columnCount)
+			{
+				Scatter(perm, u, vals);
+				skyline.Update(std::span<T>(vals), std::span<T>(work));
+			}
+			else
 			{
-				x[i] *= norm[i];
+				Update(ld, &compressed, perm, u, vals);
 			}
 
-			x = Permute(x, [&](int i) { return perm.GetPrimary(i); });
+			SolveTo(x);
+		}
+
+		std::vector<T> Downdate(SparseArray<T>& u, T v)
+		{
+			std::vector<T> x(ld.rowCount);
+			Downdate(u, v, std::span<T>(x));
 
 			return std::move(x);
 		}
 
-		std::vector<T> Downdate(SparseArray<T>& u, T v)
+		void Downdate(const SparseArray<T>& u, T v, std::span<T> x)
 		{
 			assert(ld.rowCount == u.size);
+			assert(ld.rowCount == (I)x.size());
 
 			const T zero = (T)0;
 			for (auto it = u.begin(); it != u.end(); ++it)
 			{
 				if (zero != it->second)
 				{
-					int i = perm.GetPrimary(it->first);
+					I i = perm.GetPrimary(it->first);
 					y[i] -= v * it->second * norm[i];
 				}
 			}
 
-			Downdate(ld, perm, u, tolerance);
-
-			std::vector<T> x(ld.rowCount);
-			SolveTo(ld, y, x);
-
-			for (int i = 0; i < u.size; i++)
+			if (skyline.size == ld.columnCount)
 			{
-				x[i] *= norm[i];
+				Scatter(perm, u, vals);
+				skyline.Downdate(std::span<T>(vals), tolerance, std::span<T>(work));
+			}
+			else
+			{
+				Downdate(ld, &compressed, perm, u, tolerance, vals, work);
 			}
 
-			x = Permute(x, [&](int i) { return perm.GetPrimary(i); });
-
-			return std::move(x);
+			SolveTo(x);
 		}
 
-		SparseMatrix<T> CholSym(SparseMatrix<T>& symm)
+		SparseMatrix<T, I, O> CholSym(SparseMatrix<T, I, O>& symm)
 		{
 			assert(Layout::LowerSymmetric == symm.layout);
 
-			int n = symm.rowCount;
+			tree = BasicEliminationTree<I>::Build(symm);
 
-			misc::CommonGraph<T> g(n);
-			auto it = g.GetIterator();
+			return std::move(CholSym(symm, tree));
+		}
 
-			std::stack<int> columns;
-			list.Clear();
+		SparseMatrix<T, I, O> CholSym(SparseMatrix<T, I, O>& symm, BasicEliminationTree<I>& tree)
+		{
+			assert(Layout::LowerSymmetric == symm.layout);
+			assert(symm.columnCount == tree.size);
+
+			return std::move(BuildPattern(tree, [&](I i, auto&& walk)
+				{
+					for (O p = symm.rows[i]; p < symm.rows[i + 1]; p++)
+					{
+						walk(symm.rowsColumns[p]);
+					}
+				}));
+		}
+
+		SparseMatrix<T, I, O> SqrCholSym(SparseMatrix<T, I, O>& a, BasicPermutation<I>& perm, BasicEliminationTree<I>& tree)
+		{
+			assert(Layout::DefaultLayout == a.layout);
+			assert(a.columnCount == tree.size);
 
-			for (int i = 0; i < n; i++)
+			std::vector<I> first(a.rowCount, a.columnCount);
+			for (I r = 0; r < a.rowCount; r++)
 			{
-				for (int j = symm.rows[i]; j < symm.rows[i + 1]; j++)
+				for (O p = a.rows[r]; p < a.rows[r + 1]; p++)
 				{
-					int jj = symm.rowsColumns[j];
-					list.Push(jj);
-					columns.push(jj);
+					first[r] = std::min(first[r], perm.GetPrimary(a.rowsColumns[p]));
 				}
+			}
 
-				while (columns.size() > 0)
+			return std::move(BuildPattern(tree, [&](I i, auto&& walk)
 				{
-					int jj = columns.top();
-					columns.pop();
-
-					if (!g.HasConnections(jj))
+					I ii = perm.GetPermuted(i);
+					for (O p = a.columns[ii]; p < a.columns[ii + 1]; p++)
 					{
-						continue;
+						walk(first[a.columnsRows[p]]);
 					}
+				}));
+		}
+
+		void CholTo(SparseMatrix<T, I, O>& sym, SparseMatrix<T, I, O>& ld)
+		{
+			assert(Layout::LowerSymmetric == sym.layout);
+			assert(Layout::LowerTriangle == ld.layout);
+
+			I n = sym.rowCount;
+
+			if (threadCount > 1)
+			{
+				CholTo(sym, ld, GetPool());
+				return;
+			}
+
+			if ((I)acc.size() < n)
+			{
+				acc.assign(n, T());
+			}
+
+			links.Reset(n);
+			for (I j = 0; j < n; j++)
+			{
+				CholColumn(sym, ld, j, acc, links, updates);
+				links.Advance(ld, j);
+			}
+		}
+
+		void CholTo(SparseMatrix<T, I, O>& sym, SparseMatrix<T, I, O>& ld, misc::ThreadPool& pool)
+		{
+			assert(Layout::LowerSymmetric == sym.layout);
+			assert(Layout::LowerTriangle == ld.layout);
+
+			I n = sym.rowCount;
+
+			bool own = &ld == &this->ld;
+			if (!own || tasks.empty() || (int)threadAccs.size() != pool.size)
+			{
+				ScheduleColumns(ld, pool.size);
+			}
+
+			links.Reset(n);
+			links.deferred.assign(n, false);
+			for (I j : top)
+			{
+				links.deferred[j] = true;
+			}
 
-					it.Setup(jj);
-					while (it.HasNext())
+			std::atomic<int> next(0);
+			pool.Run([&](int thread)
+				{
+					for (int t = next++; t < (int)tasks.size() - 1; t = next++)
 					{
-						int r = it.Next().first;
-						if (jj == r)
-						{
-							continue;
-						}
-						if (!list.Contains(r))
+						for (I i = tasks[t]; i < tasks[t + 1]; i++)
 						{
-							list.Push(r);
-							columns.push(r);
+							CholColumn(sym, ld, tasksNodes[i], threadAccs[thread], links, threadUpdates[thread]);
+							links.Advance(ld, tasksNodes[i]);
 						}
 					}
+				});
+
+			links.deferred.clear();
+			for (I j : tasksNodes)
+			{
+				links.Link(ld, j);
+			}
+
+			if ((I)acc.size() < n)
+			{
+				acc.assign(n, T());
+			}
+
+			for (I j : top)
+			{
+				I count = (I)(ld.columns[j + 1] - ld.columns[j]);
+				if (count < parallelColumnSize)
+				{
+					CholColumn(sym, ld, j, acc, links, updates);
+					links.Advance(ld, j);
+					continue;
 				}
 
-				while (!list.IsEmpty())
+				for (O i = sym.columns[j]; i < sym.columns[j + 1]; i++)
 				{
-					g.Insert(list.Pop(), i, T());
+					acc[sym.columnsRows[i]] = sym.values[i];
 				}
-			}
 
-			auto c = SparseMatrix<T>::FromGraph(n, n, g);
-			auto ct = c.Transpose();
-			ct.layout = Layout::LowerTriangle;
+				links.Collect(j, updates);
+
+				O first = ld.columns[j];
+				pool.For(0, count, [&](int /*thread*/, int from, int to)
+					{
+						UpdateColumn(ld, acc, links, updates, ld.columnsRows[first + from], ld.columnsRows[first + to - 1]);
+					});
 
-			return std::move(ct);
+				FinishColumn(ld, j, acc);
+				links.Advance(ld, j);
+			}
+
+			if (!own)
+			{
+				tasks.clear();
+			}
 		}
 
-		void CholTo(SparseMatrix<T>& sym, SparseMatrix<T>& ld)
+		void SolveTo(SparseMatrix<T, I, O>& ld, std::vector<T>& b, std::vector<T>& result)
 		{
-			assert(Layout::LowerSymmetric == sym.layout);
 			assert(Layout::LowerTriangle == ld.layout);
+			assert((I)b.size() == ld.rowCount);
 
-			int n = sym.rowCount;
-			T zero = (T)0;
+			result.resize(ld.rowCount);
+
+			if (threadCount > 1 && &ld == &this->ld && ld.HasRows() && ld.rowCount >= parallelSolveSize)
+			{
+				SolveLowerTo(ld, std::span<const T>(b), std::span<T>(result), GetPool());
+				SolveUpperTo(ld, std::span<T>(result), GetPool());
+				return;
+			}
+
+			const CompressedPattern<I, O>* pattern = &ld == &this->ld ? &compressed : nullptr;
+			SolveLowerTo(ld, pattern, b, result);
+			SolveUpperTo(ld, pattern, result);
+		}
 
-			std::vector<T> acc(n, T());
+	private:
+		void Factor(SparseMatrix<T, I, O>& a)
+		{
+			if (!a.HasRows())
+			{
+				a.BuildRows();
+			}
 
-			for (int j = 0; j < n; j++)
+			if (ata.columnCount != ld.columnCount)
 			{
-				for (int i = sym.columns[j]; i < sym.columns[j + 1]; i++)
+				ata = SparseMatrix<T, I, O>(std::move(SqrSym(a, perm)));
+				if (compactStorage)
 				{
-					acc[sym.columnsRows[i]] = sym.values[i];
+					ata.DropRows();
 				}
+			}
 
-				for (int k = ld.rows[j]; k < ld.rows[j + 1] && ld.rowsColumns[k] < j; k++)
-				{
-					int r = ld.rowsColumns[k];
-					T a = ld.values[ld.positions[k]] * ld.values[ld.columns[r]];
+			SqrTo(a, perm, ata);
 
-					for (int i = ld.positions[k]; i < ld.columns[r + 1]; i++)
-					{
-						acc[ld.columnsRows[i]] -= a * ld.values[i];
-					}
+			Normalization::NormTo(normalization, ata, norm);
+
+			if (!IsSkyline() || skyline.size != ld.columnCount)
+			{
+				ExpandRows();
+			}
+
+			if (Factorization::Type::Supernodal == factorization)
+			{
+				if (supernodal.size != ld.columnCount)
+				{
+					supernodal = SupernodalMatrix<T, I, O>::FromPattern(ld);
 				}
 
-				T d = ld.values[ld.columns[j]] = acc[j];
-				if (d <= zero)
+				if (threadCount > 1)
+				{
+					supernodal.CholTo(ata, tolerance, GetPool());
+				}
+				else
+				{
+					supernodal.CholTo(ata, tolerance);
+				}
+				supernodal.CopyTo(ld);
+				skyline = SkylineMatrix<T, I, O>();
+			}
+			else if (IsSkyline())
+			{
+				if (skyline.size != ld.columnCount)
 				{
-					d = tolerance;
+					skyline = SkylineMatrix<T, I, O>::FromPattern(ld);
 				}
 
-				for (int k = ld.columns[j] + 1; k < ld.columns[j + 1]; k++)
+				skyline.CholTo(ata, tolerance);
+			}
+			else
+			{
+				CholTo(ata, ld);
+				skyline = SkylineMatrix<T, I, O>();
+			}
+
+			ReleaseRows();
+		}
+
+		void ExpandRows()
+		{
+			if (compressed.size == ld.columnCount && ld.columnsRows.empty())
+			{
+				compressed.DecodeTo(ld);
+			}
+		}
+
+		void ReleaseRows()
+		{
+			if (compressed.size == ld.columnCount)
+			{
+				std::vector<I>().swap(ld.columnsRows);
+			}
+		}
+
+		template<class Func>
+		static SparseMatrix<T, I, O> BuildPattern(BasicEliminationTree<I>& tree, Func&& forEachStart)
+		{
+			I n = tree.size;
+			long long nnz = tree.GetNnz();
+			assert(nnz <= std::numeric_limits<O>::max());
+
+			auto ld = SparseMatrix<T, I, O>::Empty(n, n, (O)nnz);
+			ld.layout = Layout::LowerTriangle;
+			ld.nnz = (O)nnz;
+
+			for (I j = 0; j < n; j++)
+			{
+				ld.columns[j + 1] = ld.columns[j] + tree.columnCounts[j];
+				ld.rows[j + 1] = ld.rows[j] + tree.rowCounts[j];
+			}
+
+			std::vector<O> next(ld.columns.begin(), ld.columns.end() - 1);
+			std::vector<I> flag(n, -1);
+
+			for (I i = 0; i < n; i++)
+			{
+				flag[i] = i;
+				ld.columnsRows[next[i]++] = i;
+
+				forEachStart(i, [&](I start)
+					{
+						for (I k = start; flag[k] != i; k = tree.parent[k])
+						{
+							flag[k] = i;
+							ld.columnsRows[next[k]++] = i;
+						}
+					});
+			}
+
+			std::copy(ld.rows.begin(), ld.rows.end() - 1, next.begin());
+			for (I j = 0; j < n; j++)
+			{
+				for (O p = ld.columns[j]; p < ld.columns[j + 1]; p++)
 				{
-					ld.values[k] = acc[ld.columnsRows[k]] / d;
-					acc[ld.columnsRows[k]] = T();
+					I i = ld.columnsRows[p];
+					ld.rowsColumns[next[i]] = j;
+					ld.positions[next[i]] = p;
+					next[i] += 1;
 				}
 			}
+
+			return std::move(ld);
 		}
 
-		void SolveTo(SparseMatrix<T>& ld, std::vector<T>& b, std::vector<T>& result)
+		bool IsSkyline() const
 		{
-			assert(Layout::LowerTriangle == ld.layout);
-			assert((int)b.size() == ld.rowCount);
+			return Factorization::Type::Skyline == factorization || (Factorization::Type::LeftLooking == factorization && banded);
+		}
+
+		bool IsBanded(SparseMatrix<T, I, O>& ld)
+		{
+			long long profile = SkylineMatrix<T, I, O>::GetProfile(ld);
+
+			return profile >= (long long)skylineWidth * ld.columnCount && profile <= skylineProfile * ld.nnz;
+		}
+
+		void ScheduleColumns(SparseMatrix<T, I, O>& ld, int threads)
+		{
+			I n = ld.columnCount;
 
-			auto y = SolveLower(ld, b);
+			std::vector<I> parent(n);
+			std::vector<double> cost(n);
+			for (I j = 0; j < n; j++)
+			{
+				O k = ld.columns[j] + 1;
+				parent[j] = k < ld.columns[j + 1] ? ld.columnsRows[k] : -1;
 
-			auto z = SolveDiag(ld, y);
+				double count = ld.columns[j + 1] - ld.columns[j];
+				cost[j] = count * count;
+			}
 
-			auto x = SolveUpper(ld, z);
+			BasicEliminationTree<I>::Schedule(parent, cost, threads, tasks, tasksNodes, top);
 
-			result.assign(x.begin(), x.end());
+			threadAccs.assign(threads, std::vector<T>(n, T()));
+			threadUpdates.assign(threads, std::vector<I>());
+			for (int t = 0; t < threads; t++)
+			{
+				threadUpdates[t].reserve(n);
+			}
 		}
 
-	private:
+		misc::ThreadPool& GetPool()
+		{
+			if (!pool || pool->size != threadCount)
+			{
+				pool = std::make_unique<misc::ThreadPool>(threadCount);
+			}
+
+			return *pool;
+		}
+
+		void CholColumn(SparseMatrix<T, I, O>& sym, SparseMatrix<T, I, O>& ld, I j, std::vector<T>& acc, const Links& links,
+			std::vector<I>& updates)
+		{
+			for (O i = sym.columns[j]; i < sym.columns[j + 1]; i++)
+			{
+				acc[sym.columnsRows[i]] = sym.values[i];
+			}
+
+			links.Collect(j, updates);
+			for (I r : updates)
+			{
+				O p = links.nexts[r];
+				T a = ld.values[p] * ld.values[ld.columns[r]];
+
+				for (O i = p; i < ld.columns[r + 1]; i++)
+				{
+					acc[ld.columnsRows[i]] -= a * ld.values[i];
+				}
+			}
 
-		SparseMatrix<T> SqrSym(SparseMatrix<T>& a, Permutation& perm)
+			FinishColumn(ld, j, acc);
+		}
+
+		static void UpdateColumn(SparseMatrix<T, I, O>& ld, std::vector<T>& acc, const Links& links, const std::vector<I>& updates,
+			I firstRow, I lastRow)
+		{
+			for (I r : updates)
+			{
+				O p = links.nexts[r];
+				T a = ld.values[p] * ld.values[ld.columns[r]];
+
+				auto begin = ld.columnsRows.begin();
+				O i = (O)(std::lower_bound(begin + p, begin + ld.columns[r + 1], firstRow) - begin);
+
+				for (; i < ld.columns[r + 1] && ld.columnsRows[i] <= lastRow; i++)
+				{
+					acc[ld.columnsRows[i]] -= a * ld.values[i];
+				}
+			}
+		}
+
+		void FinishColumn(SparseMatrix<T, I, O>& ld, I j, std::vector<T>& acc)
+		{
+			const T zero = (T)0;
+
+			T d = ld.values[ld.columns[j]] = acc[j];
+			acc[j] = T();
+			if (d <= zero)
+			{
+				d = tolerance;
+			}
+
+			for (O k = ld.columns[j] + 1; k < ld.columns[j + 1]; k++)
+			{
+				ld.values[k] = acc[ld.columnsRows[k]] / d;
+				acc[ld.columnsRows[k]] = T();
+			}
+		}
+
+		SparseMatrix<T, I, O> SqrSym(SparseMatrix<T, I, O>& a, BasicPermutation<I>& perm)
 		{
 			assert(Layout::DefaultLayout == a.layout);
 
-			misc::CommonGraph<T> g(a.columnCount, a.columnCount);
+			I n = a.columnCount;
+
+			auto s = SparseMatrix<T, I, O>::Empty(n, n, 0);
+			s.layout = Layout::LowerSymmetric;
 			list.Clear();
 
-			for (int j = 0; j < a.columnCount; j++)
+			for (I j = 0; j < n; j++)
 			{
-				int jj = perm.GetPermuted(j);
-				for (int i = a.columns[jj]; i < a.columns[jj + 1]; i++)
+				I jj = perm.GetPermuted(j);
+				for (O i = a.columns[jj]; i < a.columns[jj + 1]; i++)
 				{
-					int ii = a.columnsRows[i];
-					for (int k = a.rows[ii]; k < a.rows[ii + 1]; k++)
+					I ii = a.columnsRows[i];
+					for (O k = a.rows[ii]; k < a.rows[ii + 1]; k++)
 					{
-						int r = perm.GetPrimary(a.rowsColumns[k]);
+						I r = perm.GetPrimary(a.rowsColumns[k]);
 						if (r < j)
 						{
 							continue;
@@ -284,158 +823,447 @@ namespace spandex
 
 				list.Push(j);
 
+				auto first = s.columnsRows.size();
 				while (!list.IsEmpty())
 				{
-					g.Insert(list.Pop(), j, T());
+					s.columnsRows.push_back(list.Pop());
 				}
+				std::sort(s.columnsRows.begin() + first, s.columnsRows.end());
+
+				s.columns[j + 1] = (O)s.columnsRows.size();
 			}
 
-			auto s = SparseMatrix<T>::FromGraph(a.columnCount, a.columnCount, g);
-			s.layout = Layout::LowerSymmetric;
+			s.nnz = s.columns[n];
+			s.values.assign(s.nnz, T());
+			s.BuildRows();
 
 			return std::move(s);
 		}
 
-		void SqrTo(SparseMatrix<T>& a, Permutation& perm, SparseMatrix<T>& ata)
+		void SqrTo(SparseMatrix<T, I, O>& a, BasicPermutation<I>& perm, SparseMatrix<T, I, O>& ata)
 		{
 			assert(Layout::DefaultLayout == a.layout);
 			assert(Layout::LowerSymmetric == ata.layout);
 
-			std::vector<T> acc(a.columnCount);
+			if ((I)acc.size() < a.columnCount)
+			{
+				acc.assign(a.columnCount, T());
+			}
 
-			for (int j = 0; j < a.columnCount; j++)
+			for (I j = 0; j < a.columnCount; j++)
 			{
-				int jj = perm.GetPermuted(j);
-				for (int i = a.columns[jj]; i < a.columns[jj + 1]; i++)
+				I jj = perm.GetPermuted(j);
+				for (O i = a.columns[jj]; i < a.columns[jj + 1]; i++)
 				{
-					int ii = a.columnsRows[i];
+					I ii = a.columnsRows[i];
 
-					for (int k = a.rows[ii]; k < a.rows[ii + 1]; k++)
+					for (O k = a.rows[ii]; k < a.rows[ii + 1]; k++)
 					{
-						int r = perm.GetPrimary(a.rowsColumns[k]);
+						I r = perm.GetPrimary(a.rowsColumns[k]);
+						if (r < j)
+						{
+							continue;
+						}
 
 						acc[r] += a.values[i] * a.values[a.positions[k]];
 					}
 				}
 
-				for (int i = ata.columns[j]; i < ata.columns[j + 1]; i++)
+				for (O i = ata.columns[j]; i < ata.columns[j + 1]; i++)
 				{
-					int r = ata.columnsRows[i];
+					I r = ata.columnsRows[i];
 					ata.values[i] = acc[r];
 					acc[r] = T();
 				}
 			}
 		}
 
-		static std::vector<T> Permute(std::vector<T>& values, std::function<int(int)> indexFunc)
+		static void MulTo(SparseMatrix<T, I, O>& a, std::vector<T>& b, std::vector<T>& c, int k)
+		{
+			assert(a.rowCount * k == (I)b.size());
+			assert(a.columnCount * k == (I)c.size());
+
+			std::fill(std::begin(c), std::end(c), (T)0);
+
+			for (I j = 0; j < a.columnCount; j++)
+			{
+				T* target = &c[j * k];
+
+				for (O i = a.columns[j]; i < a.columns[j + 1]; i++)
+				{
+					T value = a.values[i];
+					const T* source = &b[a.columnsRows[i]];
+
+					for (int t = 0; t < k; t++)
+					{
+						target[t] += source[t * a.rowCount] * value;
+					}
+				}
+			}
+		}
+
+		void SolveTo(std::span<T> x)
 		{
-			int n = (int)values.size();
-			std::vector<T> result(n);
+			I n = ld.rowCount;
 
-			for (int i = 0; i < n; i++)
+			if (skyline.size == n)
+			{
+				skyline.SolveLowerTo(std::span<const T>(y), std::span<T>(work));
+				skyline.SolveUpperTo(std::span<T>(work));
+			}
+			else if (threadCount > 1 && ld.HasRows() && ld.rowCount >= parallelSolveSize)
 			{
-				result[i] = values[indexFunc(i)];
+				SolveLowerTo(ld, std::span<const T>(y), std::span<T>(work), GetPool());
+				SolveUpperTo(ld, std::span<T>(work), GetPool());
+			}
+			else
+			{
+				SolveLowerTo(ld, &compressed, y, work);
+				SolveUpperTo(ld, &compressed, work);
 			}
 
-			return std::move(result);
+			for (I i = 0; i < n; i++)
+			{
+				I ii = perm.GetPrimary(i);
+				x[i] = work[ii] * norm[ii];
+			}
 		}
 
-		static void MulTo(SparseMatrix<T>& a, std::vector<T>& b, std::vector<T>& c)
+		static void SolveLowerTo(SparseMatrix<T, I, O>& ld, const CompressedPattern<I, O>* pattern, std::span<const T> b, std::span<T> y)
 		{
-			assert(a.rowCount == (int)b.size());
-			assert(a.columnCount == (int)c.size());
+			I n = ld.rowCount;
 
-			std::fill(std::begin(c), std::end(c), (T)0);
+			if (nullptr != pattern && pattern->size == n)
+			{
+				pattern->SolveLowerTo(ld, b, y);
+				return;
+			}
 
-			for (int i = 0; i < a.rowCount; i++)
+			if (!ld.HasRows())
 			{
-				for (int j = a.rows[i]; j < a.rows[i + 1]; j++)
+				std::copy(b.begin(), b.end(), y.begin());
+
+				for (I j = 0; j < n; j++)
 				{
-					c[a.rowsColumns[j]] += b[i] * a.values[a.positions[j]];
+					T yj = y[j];
+					for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+					{
+						y[ld.columnsRows[i]] -= ld.values[i] * yj;
+					}
 				}
+				return;
+			}
+
+			for (I i = 0; i < n; i++)
+			{
+				T sum = (T)0;
+				for (O j = ld.rows[i]; j < (ld.rows[i + 1] - 1); j++)
+				{
+					sum += ld.values[ld.positions[j]] * y[ld.rowsColumns[j]];
+				}
+				y[i] = b[i] - sum;
 			}
 		}
 
-		static std::vector<T> SolveLower(SparseMatrix<T>& ld, std::vector<T>& b)
+		static void SolveUpperTo(SparseMatrix<T, I, O>& ld, const CompressedPattern<I, O>* pattern, std::span<T> x)
 		{
-			assert(Layout::LowerTriangle == ld.layout);
-			assert((int)b.size() == ld.rowCount);
+			I n = ld.rowCount;
 
-			int n = ld.rowCount;
-			std::vector<T> y(n);
+			if (nullptr != pattern && pattern->size == n)
+			{
+				pattern->SolveUpperTo(ld, x);
+				return;
+			}
 
-			for (int i = 0; i < n; i++)
+			for (I j = (n - 1); j >= 0; j--)
 			{
 				T sum = (T)0;
-				for (int j = ld.rows[i]; j < (ld.rows[i + 1] - 1); j++)
+				for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
 				{
-					sum += ld.values[ld.positions[j]] * y[ld.rowsColumns[j]];
+					sum += ld.values[i] * x[ld.columnsRows[i]];
+				}
+				x[j] = x[j] / ld.values[ld.columns[j]] - sum;
+			}
+		}
+
+		static std::vector<T> SolveLower(SparseMatrix<T, I, O>& ld, std::vector<T>& b, int k)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+			assert((I)b.size() == ld.rowCount * k);
+
+			I n = ld.rowCount;
+			std::vector<T> y(n * k);
+			std::vector<T> sum(k);
+
+			if (!ld.HasRows())
+			{
+				std::copy(b.begin(), b.end(), y.begin());
+
+				for (I j = 0; j < n; j++)
+				{
+					const T* source = &y[j * k];
+					for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+					{
+						T value = ld.values[i];
+						T* target = &y[ld.columnsRows[i] * k];
+
+						for (int t = 0; t < k; t++)
+						{
+							target[t] -= value * source[t];
+						}
+					}
+				}
+
+				return std::move(y);
+			}
+
+			for (I i = 0; i < n; i++)
+			{
+				std::fill(sum.begin(), sum.end(), (T)0);
+				for (O j = ld.rows[i]; j < (ld.rows[i + 1] - 1); j++)
+				{
+					T value = ld.values[ld.positions[j]];
+					const T* source = &y[ld.rowsColumns[j] * k];
+
+					for (int t = 0; t < k; t++)
+					{
+						sum[t] += value * source[t];
+					}
+				}
+				for (int t = 0; t < k; t++)
+				{
+					y[i * k + t] = b[i * k + t] - sum[t];
 				}
-				y[i] = b[i] - sum;
 			}
 
 			return std::move(y);
 		}
 
-		static std::vector<T> SolveDiag(SparseMatrix<T>& ld, std::vector<T>& y)
+		static std::vector<T> SolveDiag(SparseMatrix<T, I, O>& ld, std::vector<T>& y, int k)
 		{
 			assert(Layout::LowerTriangle == ld.layout);
-			assert((int)y.size() == ld.rowCount);
+			assert((I)y.size() == ld.rowCount * k);
 
-			int n = ld.rowCount;
-			std::vector<T> x(n);
+			I n = ld.rowCount;
+			std::vector<T> x(n * k);
 
-			for (int j = (n - 1); j >= 0; j--)
+			for (I j = 0; j < n; j++)
 			{
-				x[j] = y[j] / ld.values[ld.columns[j]];
+				T d = ld.values[ld.columns[j]];
+				for (int t = 0; t < k; t++)
+				{
+					x[j * k + t] = y[j * k + t] / d;
+				}
 			}
 
 			return std::move(x);
 		}
 
-		static std::vector<T> SolveUpper(SparseMatrix<T>& ld, std::vector<T>& z)
+		static std::vector<T> SolveUpper(SparseMatrix<T, I, O>& ld, std::vector<T>& z, int k)
 		{
 			assert(Layout::LowerTriangle == ld.layout);
-			assert((int)z.size() == ld.rowCount);
+			assert((I)z.size() == ld.rowCount * k);
 
-			int n = ld.rowCount;
-			std::vector<T> x(n);
+			I n = ld.rowCount;
+			std::vector<T> x(n * k);
+			std::vector<T> sum(k);
 
-			for (int j = (n - 1); j >= 0; j--)
+			for (I j = (n - 1); j >= 0; j--)
 			{
-				T sum = (T)0;
-				for (int i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+				std::fill(sum.begin(), sum.end(), (T)0);
+				for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
 				{
-					sum += ld.values[i] * x[ld.columnsRows[i]];
+					T value = ld.values[i];
+					const T* source = &x[ld.columnsRows[i] * k];
+
+					for (int t = 0; t < k; t++)
+					{
+						sum[t] += value * source[t];
+					}
+				}
+				for (int t = 0; t < k; t++)
+				{
+					x[j * k + t] = z[j * k + t] - sum[t];
 				}
-				x[j] = z[j] - sum;
 			}
 
 			return std::move(x);
 		}
 
-		static void Update(SparseMatrix<T>& ld, Permutation& perm, const SparseArray<T>& u)
+		void BuildLevels(SparseMatrix<T, I, O>& ld)
 		{
-			assert(Layout::LowerTriangle == ld.layout);
-			assert(ld.rowCount == u.size);
+			I n = ld.rowCount;
+			std::vector<I> level(n, 0);
 
-			const T zero = (T)0;
-			T a = (T)1, b = zero, c = zero;
+			for (I i = 0; i < n; i++)
+			{
+				for (O j = ld.rows[i]; j < (ld.rows[i + 1] - 1); j++)
+				{
+					level[i] = std::max(level[i], level[ld.rowsColumns[j]] + 1);
+				}
+			}
+
+			GroupLevels(level, lowerLevels, lowerLevelsRows);
+
+			std::fill(level.begin(), level.end(), 0);
+			for (I j = (n - 1); j >= 0; j--)
+			{
+				for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+				{
+					level[j] = std::max(level[j], level[ld.columnsRows[i]] + 1);
+				}
+			}
+
+			GroupLevels(level, upperLevels, upperLevelsColumns);
+		}
+
+		static void GroupLevels(const std::vector<I>& level, std::vector<I>& levels, std::vector<I>& items)
+		{
+			I n = (I)level.size();
+			I count = 0;
+			for (I i = 0; i < n; i++)
+			{
+				count = std::max(count, level[i] + 1);
+			}
+
+			levels.assign(1 + count, 0);
+			for (I i = 0; i < n; i++)
+			{
+				levels[level[i] + 1] += 1;
+			}
+			for (I l = 0; l < count; l++)
+			{
+				levels[l + 1] += levels[l];
+			}
+
+			items.resize(n);
+			std::vector<I> next(levels.begin(), levels.end() - 1);
+			for (I i = 0; i < n; i++)
+			{
+				items[next[level[i]]++] = i;
+			}
+		}
+
+		void SolveLowerTo(SparseMatrix<T, I, O>& ld, std::span<const T> b, std::span<T> y, misc::ThreadPool& pool)
+		{
+			if (lowerLevels.empty())
+			{
+				BuildLevels(ld);
+			}
+
+			auto solve = [&](int /*thread*/, int from, int to)
+			{
+				for (int k = from; k < to; k++)
+				{
+					I i = lowerLevelsRows[k];
+
+					T sum = (T)0;
+					for (O j = ld.rows[i]; j < (ld.rows[i + 1] - 1); j++)
+					{
+						sum += ld.values[ld.positions[j]] * y[ld.rowsColumns[j]];
+					}
+					y[i] = b[i] - sum;
+				}
+			};
+
+			for (int l = 0; l < (int)lowerLevels.size() - 1; l++)
+			{
+				if (lowerLevels[l + 1] - lowerLevels[l] < parallelLevelSize)
+				{
+					solve(0, lowerLevels[l], lowerLevels[l + 1]);
+				}
+				else
+				{
+					pool.For(lowerLevels[l], lowerLevels[l + 1], solve);
+				}
+			}
+		}
+
+		void SolveUpperTo(SparseMatrix<T, I, O>& ld, std::span<T> x, misc::ThreadPool& pool)
+		{
+			if (upperLevels.empty())
+			{
+				BuildLevels(ld);
+			}
+
+			auto solve = [&](int /*thread*/, int from, int to)
+			{
+				for (int k = from; k < to; k++)
+				{
+					I j = upperLevelsColumns[k];
+
+					T sum = (T)0;
+					for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+					{
+						sum += ld.values[i] * x[ld.columnsRows[i]];
+					}
+					x[j] = x[j] / ld.values[ld.columns[j]] - sum;
+				}
+			};
+
+			for (int l = 0; l < (int)upperLevels.size() - 1; l++)
+			{
+				if (upperLevels[l + 1] - upperLevels[l] < parallelLevelSize)
+				{
+					solve(0, upperLevels[l], upperLevels[l + 1]);
+				}
+				else
+				{
+					pool.For(upperLevels[l], upperLevels[l + 1], solve);
+				}
+			}
+		}
 
-			std::vector<T> vals(u.size, zero);
+		template<class Func>
+		static void ForEachLower(SparseMatrix<T, I, O>& ld, const CompressedPattern<I, O>* pattern, I j, Func&& func)
+		{
+			if (nullptr != pattern && pattern->size == ld.columnCount)
+			{
+				O first = ld.columns[j] + 1;
+				pattern->ForEachRun(j, [&](I row, I length, O k)
+					{
+						for (I t = 0; t < length; t++)
+						{
+							func(first + k + t, row + t);
+						}
+					});
+				return;
+			}
+
+			for (O i = ld.columns[j] + 1; i < ld.columns[j + 1]; i++)
+			{
+				func(i, ld.columnsRows[i]);
+			}
+		}
+
+		static void Scatter(BasicPermutation<I>& perm, const SparseArray<T>& u, std::vector<T>& vals)
+		{
+			std::fill(vals.begin(), vals.end(), (T)0);
 			for (auto it = u.begin(); it != u.end(); ++it)
 			{
 				vals[perm.GetPrimary(it->first)] = it->second;
 			}
+		}
+
+		static void Update(SparseMatrix<T, I, O>& ld, const CompressedPattern<I, O>* pattern, BasicPermutation<I>& perm,
+			const SparseArray<T>& u, std::vector<T>& vals)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+			assert(ld.rowCount == u.size);
 
-			for (int j = 0; j < u.size; j++)
+			const T zero = (T)0;
+			T a = (T)1, b = zero, c = zero;
+
+			Scatter(perm, u, vals);
+
+			for (I j = 0; j < u.size; j++)
 			{
 				if (zero == vals[j])
 				{
 					continue;
 				}
 
-				int jj = ld.columns[j];
+				O jj = ld.columns[j];
 
 				T diag = ld.values[jj];
 				T x = vals[j];
@@ -444,17 +1272,16 @@ namespace spandex
 				c = x / (diag * b);
 				a = b;
 
-				for (int i = jj + 1; i < ld.columns[j + 1]; i++)
-				{
-					int ii = ld.columnsRows[i];
-
-					vals[ii] -= x * ld.values[i];
-					ld.values[i] += c * vals[ii];
-				}
+				ForEachLower(ld, pattern, j, [&](O i, I ii)
+					{
+						vals[ii] -= x * ld.values[i];
+						ld.values[i] += c * vals[ii];
+					});
 			}
 		}
 
-		static void Downdate(SparseMatrix<T>& ld, Permutation& perm, const SparseArray<T>& u, T tolerance)
+		static void Downdate(SparseMatrix<T, I, O>& ld, const CompressedPattern<I, O>* pattern, BasicPermutation<I>& perm,
+			const SparseArray<T>& u, T tolerance, std::vector<T>& vals, std::vector<T>& p)
 		{
 			assert(Layout::LowerTriangle == ld.layout);
 			assert(ld.rowCount == u.size);
@@ -462,29 +1289,14 @@ namespace spandex
 			const T zero = (T)0;
 			const T one = (T)1;
 
-			std::vector<T> vals(u.size, zero);
-			for (auto it = u.begin(); it != u.end(); ++it)
-			{
-				vals[perm.GetPrimary(it->first)] = it->second;
-			}
-
-			auto diag = ld.GetDiag();
-			for (int i = 0; i < u.size; i++)
-			{
-				ld.SetColumnwise(i, i, one);
-			}
+			Scatter(perm, u, vals);
 
-			auto p = SolveLower(ld, vals);
-
-			for (int i = 0; i < u.size; i++)
-			{
-				ld.SetColumnwise(i, i, diag[i]);
-			}
+			SolveLowerTo(ld, pattern, vals, p);
 
 			T sum = zero;
-			for (int i = 0; i < u.size; i++)
+			for (I i = 0; i < u.size; i++)
 			{
-				sum += p[i] / ld.GetColumnwise(i, i) * p[i];
+				sum += p[i] / ld.values[ld.columns[i]] * p[i];
 			}
 
 			T a = one - sum;
@@ -494,9 +1306,9 @@ namespace spandex
 				a = tolerance;
 			}
 
-			for (int j = u.size - 1; -1 != j; j--)
+			for (I j = u.size - 1; -1 != j; j--)
 			{
-				int jj = ld.columns[j];
+				O jj = ld.columns[j];
 				T d = ld.values[jj];
 
 				T b = a + p[j] * p[j] / d;
@@ -506,14 +1318,12 @@ namespace spandex
 
 				a = b;
 
-				for (int i = jj + 1; i < ld.columns[j + 1]; i++)
-				{
-					int ii = ld.columnsRows[i];
-
-					T v = vals[ii];
-					vals[ii] += p[j] * ld.values[i];
-					ld.values[i] += c * v;
-				}
+				ForEachLower(ld, pattern, j, [&](O i, I ii)
+					{
+						T v = vals[ii];
+						vals[ii] += p[j] * ld.values[i];
+						ld.values[i] += c * v;
+					});
 			}
 		}
 	};
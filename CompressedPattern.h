@@ -0,0 +1,269 @@
+#pragma once
+
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace spandex
+{
+	template<class I = int, class O = I>
+	class CompressedPattern
+	{
+	public:
+		std::vector<O> columns;
+		std::vector<std::uint8_t> bytes;
+
+		I size;
+
+		CompressedPattern() : size(0)
+		{
+		}
+
+		template<class T>
+		static CompressedPattern<I, O> FromMatrix(const SparseMatrix<T, I, O>& ld)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+
+			I n = ld.columnCount;
+
+			CompressedPattern<I, O> cp;
+			cp.size = n;
+			cp.columns.resize(1 + n, 0);
+
+			for (I j = 0; j < n; j++)
+			{
+				assert(ld.columns[j] < ld.columns[j + 1] && j == ld.columnsRows[ld.columns[j]]);
+
+				I previous = j;
+				for (O i = ld.columns[j] + 1; i < ld.columns[j + 1];)
+				{
+					I first = ld.columnsRows[i];
+					I length = 1;
+					while (i + length < ld.columns[j + 1] && ld.columnsRows[i + length] == first + length)
+					{
+						length += 1;
+					}
+
+					Put(cp.bytes, first - previous);
+					Put(cp.bytes, length);
+
+					previous = first + length - 1;
+					i += length;
+				}
+
+				cp.columns[j + 1] = (O)cp.bytes.size();
+			}
+
+			return std::move(cp);
+		}
+
+		long long GetBytes() const
+		{
+			return (long long)bytes.size() + (long long)columns.size() * sizeof(O);
+		}
+
+		std::vector<I> GetRows(I column) const
+		{
+			assert(column >= 0 && column < size);
+
+			std::vector<I> rows{ column };
+
+			ForEachRun(column, [&](I first, I length, O /*k*/)
+				{
+					for (I t = 0; t < length; t++)
+					{
+						rows.push_back(first + t);
+					}
+				});
+
+			return std::move(rows);
+		}
+
+		template<class T>
+		void DecodeTo(SparseMatrix<T, I, O>& ld) const
+		{
+			assert(size == ld.columnCount);
+
+			ld.columnsRows.resize(ld.columns[size]);
+
+			for (I j = 0; j < size; j++)
+			{
+				O p = ld.columns[j];
+				ld.columnsRows[p++] = j;
+
+				ForEachRun(j, [&](I first, I length, O /*k*/)
+					{
+						for (I t = 0; t < length; t++)
+						{
+							ld.columnsRows[p++] = first + t;
+						}
+					});
+			}
+		}
+
+		template<class T>
+		void SolveLowerTo(const SparseMatrix<T, I, O>& ld, std::span<const T> b, std::span<T> y) const
+		{
+			assert(size == ld.columnCount);
+
+			std::copy(b.begin(), b.end(), y.begin());
+
+			for (I j = 0; j < size; j++)
+			{
+				T yj = y[j];
+				const T* values = ld.values.data() + ld.columns[j] + 1;
+
+				ForEachRun(j, [&](I first, I length, O k)
+					{
+						T* target = y.data() + first;
+						const T* source = values + k;
+
+						for (I t = 0; t < length; t++)
+						{
+							target[t] -= source[t] * yj;
+						}
+					});
+			}
+		}
+
+		template<class T>
+		void SolveUpperTo(const SparseMatrix<T, I, O>& ld, std::span<T> x) const
+		{
+			assert(size == ld.columnCount);
+
+			for (I j = (size - 1); j >= 0; j--)
+			{
+				T sum = (T)0;
+				const T* values = ld.values.data() + ld.columns[j] + 1;
+
+				ForEachRun(j, [&](I first, I length, O k)
+					{
+						const T* source = x.data() + first;
+						const T* lower = values + k;
+
+						for (I t = 0; t < length; t++)
+						{
+							sum += lower[t] * source[t];
+						}
+					});
+
+				x[j] = x[j] / ld.values[ld.columns[j]] - sum;
+			}
+		}
+
+		template<class T>
+		void SolveLowerTo(const SparseMatrix<T, I, O>& ld, std::span<const T> b, std::span<T> y, int k) const
+		{
+			assert(size == ld.columnCount);
+			assert((size_t)size * k == b.size());
+
+			std::copy(b.begin(), b.end(), y.begin());
+
+			for (I j = 0; j < size; j++)
+			{
+				const T* yj = y.data() + (size_t)j * k;
+				const T* values = ld.values.data() + ld.columns[j] + 1;
+
+				ForEachRun(j, [&](I first, I length, O offset)
+					{
+						T* target = y.data() + (size_t)first * k;
+						const T* source = values + offset;
+
+						for (I r = 0; r < length; r++, target += k)
+						{
+							T value = source[r];
+							for (int t = 0; t < k; t++)
+							{
+								target[t] -= value * yj[t];
+							}
+						}
+					});
+			}
+		}
+
+		template<class T>
+		void SolveUpperTo(const SparseMatrix<T, I, O>& ld, std::span<T> x, int k) const
+		{
+			assert(size == ld.columnCount);
+			assert((size_t)size * k == x.size());
+
+			for (I j = (size - 1); j >= 0; j--)
+			{
+				T* xj = x.data() + (size_t)j * k;
+				const T* values = ld.values.data() + ld.columns[j] + 1;
+
+				T d = ld.values[ld.columns[j]];
+				for (int t = 0; t < k; t++)
+				{
+					xj[t] /= d;
+				}
+
+				ForEachRun(j, [&](I first, I length, O offset)
+					{
+						const T* source = x.data() + (size_t)first * k;
+						const T* lower = values + offset;
+
+						for (I r = 0; r < length; r++, source += k)
+						{
+							T value = lower[r];
+							for (int t = 0; t < k; t++)
+							{
+								xj[t] -= value * source[t];
+							}
+						}
+					});
+			}
+		}
+
+		template<class Func>
+		void ForEachRun(I column, Func&& func) const
+		{
+			const std::uint8_t* p = bytes.data() + columns[column];
+			const std::uint8_t* end = bytes.data() + columns[column + 1];
+
+			I row = column;
+			O k = 0;
+			while (p < end)
+			{
+				I first = row + (I)Get(p);
+				I length = (I)Get(p);
+
+				func(first, length, k);
+
+				row = first + length - 1;
+				k += length;
+			}
+		}
+
+	private:
+
+		static void Put(std::vector<std::uint8_t>& bytes, I value)
+		{
+			auto v = (unsigned long long)value;
+			while (v >= 0x80)
+			{
+				bytes.push_back((std::uint8_t)(v | 0x80));
+				v >>= 7;
+			}
+			bytes.push_back((std::uint8_t)v);
+		}
+
+		static unsigned long long Get(const std::uint8_t*& p)
+		{
+			unsigned long long v = 0;
+			int shift = 0;
+			while (*p & 0x80)
+			{
+				v |= (unsigned long long)(*p++ & 0x7f) << shift;
+				shift += 7;
+			}
+			v |= (unsigned long long)(*p++) << shift;
+
+			return v;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace spandex
+{
+	template<class I, class O = I>
+	class BasicCuthillMcKee
+	{
+	private:
+		constexpr static I NIL = -1;
+
+		I n;
+		const std::vector<O>& starts;
+		const std::vector<I>& adjacency;
+		std::vector<I> level;
+		std::vector<I> queue;
+
+		BasicCuthillMcKee(I n, const std::vector<O>& starts, const std::vector<I>& adjacency) : n(n),
+			starts(starts), adjacency(adjacency), level(n, NIL)
+		{
+			assert(n + 1 == (I)starts.size());
+		}
+
+	public:
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency)
+		{
+			BasicCuthillMcKee<I, O> cm(n, starts, adjacency);
+
+			std::vector<I> order;
+			order.reserve(n);
+
+			std::vector<bool> visited(n, false);
+			for (I i = 0; i < n; i++)
+			{
+				if (visited[i])
+				{
+					continue;
+				}
+
+				I root = cm.FindPeripheral(i);
+
+				size_t head = order.size();
+				order.push_back(root);
+				visited[root] = true;
+				for (; head < order.size(); head++)
+				{
+					I v = order[head];
+					size_t first = order.size();
+					for (O p = starts[v]; p < starts[v + 1]; p++)
+					{
+						I u = adjacency[p];
+						if (!visited[u])
+						{
+							visited[u] = true;
+							order.push_back(u);
+						}
+					}
+
+					std::sort(order.begin() + first, order.end(), [&](I a, I b)
+						{
+							I da = cm.GetDegree(a);
+							I db = cm.GetDegree(b);
+
+							return da < db || (da == db && a < b);
+						});
+				}
+			}
+
+			std::reverse(order.begin(), order.end());
+
+			return std::move(order);
+		}
+
+	private:
+		I GetDegree(I v) const
+		{
+			return (I)(starts[v + 1] - starts[v]);
+		}
+
+		I FindPeripheral(I start)
+		{
+			I root = start;
+			I height = Traverse(root);
+
+			while (true)
+			{
+				I next = NIL;
+				for (auto it = queue.rbegin(); it != queue.rend() && level[*it] == height; ++it)
+				{
+					if (NIL == next || GetDegree(*it) < GetDegree(next))
+					{
+						next = *it;
+					}
+				}
+
+				Reset();
+
+				I h = Traverse(next);
+				if (h <= height)
+				{
+					Reset();
+					return root;
+				}
+
+				root = next;
+				height = h;
+			}
+		}
+
+		I Traverse(I root)
+		{
+			queue.assign(1, root);
+			level[root] = 0;
+
+			for (size_t head = 0; head < queue.size(); head++)
+			{
+				I v = queue[head];
+				for (O p = starts[v]; p < starts[v + 1]; p++)
+				{
+					I u = adjacency[p];
+					if (NIL == level[u])
+					{
+						level[u] = level[v] + 1;
+						queue.push_back(u);
+					}
+				}
+			}
+
+			return level[queue.back()];
+		}
+
+		void Reset()
+		{
+			for (I v : queue)
+			{
+				level[v] = NIL;
+			}
+		}
+	};
+
+	using CuthillMcKee = BasicCuthillMcKee<int>;
+}
\ No newline at end of file
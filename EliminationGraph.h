@@ -10,31 +10,31 @@
 
 namespace spandex
 {
-	template<class T>
+	template<class T, class I = int, class O = I>
 	class EliminationGraph
 	{
 	private:
-		misc::CommonGraph<misc::Placeholder> adj;
-		misc::IntList list;
-		std::vector<int> size;
+		misc::CommonGraph<misc::Placeholder, I> adj;
+		misc::BasicIntList<I> list;
+		std::vector<I> size;
 
 	public:
 
-		EliminationGraph(SparseMatrix<T>& a) : list(a.columnCount), adj(a.columnCount, a.nnz)
+		EliminationGraph(SparseMatrix<T, I, O>& a) : list(a.columnCount), adj(a.columnCount, (I)a.nnz)
 		{
 			assert(Layout::DefaultLayout == a.layout);
 
-			int n = a.columnCount;
+			I n = a.columnCount;
 			size.resize(n, 0);
 
-			for (int j = 0; j < n; j++)
+			for (I j = 0; j < n; j++)
 			{
-				for (int i = a.columns[j]; i < a.columns[j + 1]; i++)
+				for (O i = a.columns[j]; i < a.columns[j + 1]; i++)
 				{
-					int ii = a.columnsRows[i];
-					for (int k = a.rows[ii]; k < a.rows[ii + 1]; k++)
+					I ii = a.columnsRows[i];
+					for (O k = a.rows[ii]; k < a.rows[ii + 1]; k++)
 					{
-						int r = a.rowsColumns[k];
+						I r = a.rowsColumns[k];
 						if (r <= j)
 						{
 							continue;
@@ -46,7 +46,7 @@ namespace spandex
 
 				while (!list.IsEmpty())
 				{
-					int i = list.Pop();
+					I i = list.Pop();
 
 					adj.Insert(i, j, misc::Placeholder());
 					adj.Insert(j, i, misc::Placeholder());
@@ -62,12 +62,12 @@ namespace spandex
 			return adj.GetIterator();
 		}
 
-		int GetSize(int vertex) const
+		I GetSize(I vertex) const
 		{
 			return size[vertex];
 		}
 
-		void Eliminate(int vertex)
+		void Eliminate(I vertex)
 		{
 			auto primary = adj.GetIterator();
 			auto secondary = adj.GetIterator();
@@ -76,12 +76,12 @@ namespace spandex
 
 			while (primary.HasNext())
 			{
-				int i = primary.Next().first;
+				I i = primary.Next().first;
 
 				secondary.Setup(i);
 				while (secondary.HasNext())
 				{
-					int j = secondary.Next().first;
+					I j = secondary.Next().first;
 
 					if (j != i && j != vertex)
 					{
@@ -92,7 +92,7 @@ namespace spandex
 				secondary.Setup(vertex);
 				while (secondary.HasNext())
 				{
-					int j = secondary.Next().first;
+					I j = secondary.Next().first;
 
 					if (j != i && j != vertex)
 					{
@@ -112,7 +112,7 @@ namespace spandex
 			adj.RemoveFrom(vertex);
 		}
 
-		bool IsLeaf(int vertex)
+		bool IsLeaf(I vertex)
 		{
 			return adj.IsLeaf(vertex);
 		}
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "SparseMatrix.h"
+#include "Permutation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+namespace spandex
+{
+	template<class I>
+	class BasicEliminationTree
+	{
+	public:
+		std::vector<I> parent;
+		std::vector<I> postorder;
+		std::vector<I> columnCounts;
+		std::vector<I> rowCounts;
+
+		I size;
+
+		BasicEliminationTree() : size(0)
+		{
+		}
+
+		template<class T, class O>
+		static BasicEliminationTree<I> Build(const SparseMatrix<T, I, O>& symm)
+		{
+			assert(Layout::LowerSymmetric == symm.layout);
+
+			I n = symm.columnCount;
+
+			BasicEliminationTree<I> tree;
+			tree.size = n;
+			tree.parent.assign(n, -1);
+
+			std::vector<I> ancestor(n, -1);
+			for (I k = 0; k < n; k++)
+			{
+				for (O p = symm.rows[k]; p < symm.rows[k + 1]; p++)
+				{
+					for (I i = symm.rowsColumns[p]; -1 != i && i < k;)
+					{
+						I next = ancestor[i];
+						ancestor[i] = k;
+						if (-1 == next)
+						{
+							tree.parent[i] = k;
+						}
+						i = next;
+					}
+				}
+			}
+
+			tree.BuildPostorder();
+			tree.BuildCounts([&](I /*k*/, I j, auto&& func)
+				{
+					for (O p = symm.columns[j]; p < symm.columns[j + 1]; p++)
+					{
+						func(symm.columnsRows[p]);
+					}
+				});
+
+			return std::move(tree);
+		}
+
+		template<class T, class O>
+		static BasicEliminationTree<I> BuildSqr(const SparseMatrix<T, I, O>& a, BasicPermutation<I>& perm)
+		{
+			assert(Layout::DefaultLayout == a.layout);
+
+			I n = a.columnCount;
+
+			BasicEliminationTree<I> tree;
+			tree.size = n;
+			tree.parent.assign(n, -1);
+
+			std::vector<I> ancestor(n, -1);
+			std::vector<I> previous(a.rowCount, -1);
+
+			for (I k = 0; k < n; k++)
+			{
+				I kk = perm.GetPermuted(k);
+				for (O p = a.columns[kk]; p < a.columns[kk + 1]; p++)
+				{
+					I r = a.columnsRows[p];
+					for (I i = previous[r]; -1 != i && i < k;)
+					{
+						I next = ancestor[i];
+						ancestor[i] = k;
+						if (-1 == next)
+						{
+							tree.parent[i] = k;
+						}
+						i = next;
+					}
+					previous[r] = k;
+				}
+			}
+
+			tree.BuildPostorder();
+
+			std::vector<I> order(n);
+			for (I k = 0; k < n; k++)
+			{
+				order[tree.postorder[k]] = k;
+			}
+
+			std::vector<I> head(n, -1);
+			std::vector<I> next(a.rowCount, -1);
+			for (I r = 0; r < a.rowCount; r++)
+			{
+				I k = n;
+				for (O p = a.rows[r]; p < a.rows[r + 1]; p++)
+				{
+					k = std::min(k, order[perm.GetPrimary(a.rowsColumns[p])]);
+				}
+				if (k < n)
+				{
+					next[r] = head[k];
+					head[k] = r;
+				}
+			}
+
+			tree.BuildCounts([&](I k, I /*j*/, auto&& func)
+				{
+					for (I r = head[k]; -1 != r; r = next[r])
+					{
+						for (O p = a.rows[r]; p < a.rows[r + 1]; p++)
+						{
+							func(perm.GetPrimary(a.rowsColumns[p]));
+						}
+					}
+				});
+
+			return std::move(tree);
+		}
+
+		long long GetNnz() const
+		{
+			long long nnz = 0;
+			for (I j = 0; j < size; j++)
+			{
+				nnz += columnCounts[j];
+			}
+
+			return nnz;
+		}
+
+		static void Schedule(const std::vector<I>& parent, const std::vector<double>& work, I threadCount,
+			std::vector<I>& tasks, std::vector<I>& tasksNodes, std::vector<I>& top)
+		{
+			I n = (I)parent.size();
+
+			double total = 0;
+			std::vector<double> subtree(work);
+			for (I j = 0; j < n; j++)
+			{
+				if (-1 == parent[j])
+				{
+					total += subtree[j];
+				}
+				else
+				{
+					subtree[parent[j]] += subtree[j];
+				}
+			}
+
+			double limit = total / (4.0 * threadCount);
+
+			std::vector<I> owner(n, -1);
+			std::vector<I> roots;
+			for (I j = n - 1; j >= 0; j--)
+			{
+				if (subtree[j] > limit)
+				{
+					continue;
+				}
+
+				if (-1 == parent[j] || subtree[parent[j]] > limit)
+				{
+					owner[j] = (I)roots.size();
+					roots.push_back(j);
+				}
+				else
+				{
+					owner[j] = owner[parent[j]];
+				}
+			}
+
+			std::vector<I> rank(roots.size());
+			std::iota(rank.begin(), rank.end(), 0);
+			std::stable_sort(rank.begin(), rank.end(),
+				[&](I x, I y) { return subtree[roots[x]] > subtree[roots[y]]; });
+
+			std::vector<I> order(roots.size());
+			for (I t = 0; t < (I)rank.size(); t++)
+			{
+				order[rank[t]] = t;
+			}
+
+			tasks.assign(1 + roots.size(), 0);
+			top.clear();
+			for (I j = 0; j < n; j++)
+			{
+				if (-1 == owner[j])
+				{
+					top.push_back(j);
+				}
+				else
+				{
+					tasks[order[owner[j]] + 1] += 1;
+				}
+			}
+
+			for (I t = 0; t < (I)roots.size(); t++)
+			{
+				tasks[t + 1] += tasks[t];
+			}
+
+			tasksNodes.resize(tasks.back());
+			std::vector<I> next(tasks.begin(), tasks.end() - 1);
+			for (I j = 0; j < n; j++)
+			{
+				if (-1 != owner[j])
+				{
+					tasksNodes[next[order[owner[j]]]++] = j;
+				}
+			}
+		}
+
+	private:
+		void BuildPostorder()
+		{
+			std::vector<I> head(size, -1);
+			std::vector<I> next(size, -1);
+
+			for (I j = size - 1; j >= 0; j--)
+			{
+				if (-1 != parent[j])
+				{
+					next[j] = head[parent[j]];
+					head[parent[j]] = j;
+				}
+			}
+
+			postorder.resize(size);
+			std::vector<I> stack;
+
+			for (I root = 0, k = 0; root < size; root++)
+			{
+				if (-1 != parent[root])
+				{
+					continue;
+				}
+
+				stack.push_back(root);
+				while (!stack.empty())
+				{
+					I j = stack.back();
+					I child = head[j];
+
+					if (-1 == child)
+					{
+						stack.pop_back();
+						postorder[k++] = j;
+					}
+					else
+					{
+						head[j] = next[child];
+						stack.push_back(child);
+					}
+				}
+			}
+		}
+
+		template<class Func>
+		void BuildCounts(Func&& forEachLower)
+		{
+			I n = size;
+
+			std::vector<I> first(n, -1);
+			std::vector<I> maxFirst(n, -1);
+			std::vector<I> prevLeaf(n, -1);
+			std::vector<I> ancestor(n);
+			std::vector<I> level(n, 0);
+
+			columnCounts.assign(n, 0);
+			rowCounts.assign(n, 1);
+
+			for (I k = 0; k < n; k++)
+			{
+				I j = postorder[k];
+				columnCounts[j] = (-1 == first[j]) ? 1 : 0;
+				for (; -1 != j && -1 == first[j]; j = parent[j])
+				{
+					first[j] = k;
+				}
+			}
+
+			for (I j = n - 1; j >= 0; j--)
+			{
+				level[j] = (-1 == parent[j]) ? 0 : level[parent[j]] + 1;
+				ancestor[j] = j;
+			}
+
+			for (I k = 0; k < n; k++)
+			{
+				I j = postorder[k];
+				if (-1 != parent[j])
+				{
+					columnCounts[parent[j]] -= 1;
+				}
+
+				forEachLower(k, j, [&](I i)
+					{
+						if (i <= j || first[j] <= maxFirst[i])
+						{
+							return;
+						}
+
+						maxFirst[i] = first[j];
+						I previous = prevLeaf[i];
+						prevLeaf[i] = j;
+
+						columnCounts[j] += 1;
+
+						if (-1 == previous)
+						{
+							rowCounts[i] += level[j] - level[i];
+							return;
+						}
+
+						I q = previous;
+						while (q != ancestor[q])
+						{
+							q = ancestor[q];
+						}
+						for (I s = previous; s != q;)
+						{
+							I t = ancestor[s];
+							ancestor[s] = q;
+							s = t;
+						}
+
+						columnCounts[q] -= 1;
+						rowCounts[i] += level[j] - level[q];
+					});
+
+				if (-1 != parent[j])
+				{
+					ancestor[j] = parent[j];
+				}
+			}
+
+			for (I j = 0; j < n; j++)
+			{
+				if (-1 != parent[j])
+				{
+					columnCounts[parent[j]] += columnCounts[j];
+				}
+			}
+		}
+	};
+	using EliminationTree = BasicEliminationTree<int>;
+}
\ No newline at end of file
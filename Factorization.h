@@ -0,0 +1,15 @@
+#pragma once
+
+namespace spandex
+{
+	class Factorization
+	{
+	public:
+		enum Type
+		{
+			LeftLooking,
+			Supernodal,
+			Skyline
+		};
+	};
+}
\ No newline at end of file
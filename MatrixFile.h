@@ -0,0 +1,238 @@
+#pragma once
+
+#include "SparseMatrix.h"
+#include "SparseMatrixView.h"
+
+#include "misc/MappedFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace spandex
+{
+	class MatrixFile
+	{
+	public:
+		static const std::uint32_t Version = 1;
+		static const std::uint64_t Alignment = 64;
+
+		enum Section
+		{
+			Columns, ColumnsRows, Values, Rows, RowsColumns, Positions, SectionCount
+		};
+
+		struct Header
+		{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t hasRows;
+			std::uint32_t layout;
+			std::uint32_t valueType;
+			std::uint32_t valueSize;
+			std::uint32_t indexSize;
+			std::uint32_t offsetSize;
+			std::uint32_t reserved;
+			std::int64_t rowCount;
+			std::int64_t columnCount;
+			std::int64_t nnz;
+			std::uint64_t offsets[SectionCount];
+			std::uint64_t sizes[SectionCount];
+		};
+
+		template<class T, class I, class O>
+		static void Save(const SparseMatrix<T, I, O>& a, const std::string& path)
+		{
+			Header header = MakeHeader<T, I, O>(a.rowCount, a.columnCount, a.nnz, a.layout, a.HasRows());
+
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				throw std::runtime_error("cannot create " + path);
+			}
+
+			file.write((const char*)&header, sizeof(Header));
+
+			const void* sections[SectionCount] = {
+				a.columns.data(), a.columnsRows.data(), a.values.data(),
+				a.rows.data(), a.rowsColumns.data(), a.positions.data() };
+
+			std::uint64_t position = sizeof(Header);
+			for (int s = 0; s < SectionCount; s++)
+			{
+				if (0 == header.sizes[s])
+				{
+					continue;
+				}
+
+				std::vector<char> padding(header.offsets[s] - position, 0);
+				file.write(padding.data(), padding.size());
+				file.write((const char*)sections[s], header.sizes[s]);
+				position = header.offsets[s] + header.sizes[s];
+			}
+
+			if (!file)
+			{
+				throw std::runtime_error("cannot write " + path);
+			}
+		}
+
+		template<class T, class I = int, class O = I>
+		static SparseMatrix<T, I, O> Load(const std::string& path)
+		{
+			return std::move(Map<T, I, O>(path, true).ToMatrix());
+		}
+
+		template<class T, class I = int, class O = I>
+		static SparseMatrixView<T, I, O> Map(const std::string& path, bool validate = false)
+		{
+			auto file = std::make_shared<misc::MappedFile>(path);
+			const std::byte* data = file->GetData();
+
+			if (file->GetSize() < sizeof(Header))
+			{
+				throw std::runtime_error("not a matrix file: " + path);
+			}
+
+			Header header;
+			std::memcpy(&header, data, sizeof(Header));
+
+			if (0 != std::memcmp(header.magic, "SPANDEX", sizeof(header.magic)))
+			{
+				throw std::runtime_error("not a matrix file: " + path);
+			}
+			if (Version != header.version)
+			{
+				throw std::runtime_error("unsupported matrix file version: " + path);
+			}
+			if (header.rowCount < 0 || header.rowCount > std::numeric_limits<I>::max() ||
+				header.columnCount < 0 || header.columnCount > std::numeric_limits<I>::max() ||
+				header.nnz < 0 || (std::uint64_t)header.nnz > (std::uint64_t)std::numeric_limits<O>::max() ||
+				header.layout > (std::uint32_t)Layout::UpperSymmetric)
+			{
+				throw std::runtime_error("corrupt matrix file: " + path);
+			}
+
+			Header expected = MakeHeader<T, I, O>((I)header.rowCount, (I)header.columnCount, (O)header.nnz,
+				(Layout)header.layout, 0 != header.hasRows);
+
+			if (header.valueType != expected.valueType || header.valueSize != expected.valueSize ||
+				header.indexSize != expected.indexSize || header.offsetSize != expected.offsetSize)
+			{
+				throw std::runtime_error("matrix file element types do not match: " + path);
+			}
+			for (int s = 0; s < SectionCount; s++)
+			{
+				if (header.offsets[s] != expected.offsets[s] || header.sizes[s] != expected.sizes[s] ||
+					(0 != header.sizes[s] && header.offsets[s] + header.sizes[s] > file->GetSize()))
+				{
+					throw std::runtime_error("corrupt matrix file: " + path);
+				}
+			}
+
+			SparseMatrixView<T, I, O> view;
+			view.layout = (Layout)header.layout;
+			view.nnz = (O)header.nnz;
+			view.rowCount = (I)header.rowCount;
+			view.columnCount = (I)header.columnCount;
+
+			view.columns = GetSection<O>(data, header, Section::Columns);
+			view.columnsRows = GetSection<I>(data, header, Section::ColumnsRows);
+			view.values = GetSection<T>(data, header, Section::Values);
+			view.rows = GetSection<O>(data, header, Section::Rows);
+			view.rowsColumns = GetSection<I>(data, header, Section::RowsColumns);
+			view.positions = GetSection<O>(data, header, Section::Positions);
+
+			if (validate && !view.IsValid())
+			{
+				throw std::runtime_error("corrupt matrix file: " + path);
+			}
+
+			view.owner = file;
+
+			return std::move(view);
+		}
+
+	private:
+		template<class T>
+		static std::uint32_t GetValueType()
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+				return 1;
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				return 2;
+			}
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+			{
+				return 3;
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				return 4;
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template<class T, class I, class O>
+		static Header MakeHeader(I rowCount, I columnCount, O nnz, Layout layout, bool hasRows)
+		{
+			Header header;
+			std::memset(&header, 0, sizeof(Header));
+			std::memcpy(header.magic, "SPANDEX", 8);
+
+			header.version = Version;
+			header.hasRows = hasRows ? 1 : 0;
+			header.layout = (std::uint32_t)layout;
+			header.valueType = GetValueType<T>();
+			header.valueSize = sizeof(T);
+			header.indexSize = sizeof(I);
+			header.offsetSize = sizeof(O);
+			header.rowCount = rowCount;
+			header.columnCount = columnCount;
+			header.nnz = nnz;
+
+			header.sizes[Section::Columns] = sizeof(O) * (1 + (std::uint64_t)columnCount);
+			header.sizes[Section::ColumnsRows] = sizeof(I) * (std::uint64_t)nnz;
+			header.sizes[Section::Values] = sizeof(T) * (std::uint64_t)nnz;
+			if (hasRows)
+			{
+				header.sizes[Section::Rows] = sizeof(O) * (1 + (std::uint64_t)rowCount);
+				header.sizes[Section::RowsColumns] = sizeof(I) * (std::uint64_t)nnz;
+				header.sizes[Section::Positions] = sizeof(O) * (std::uint64_t)nnz;
+			}
+
+			std::uint64_t position = sizeof(Header);
+			for (int s = 0; s < SectionCount; s++)
+			{
+				position = (position + Alignment - 1) / Alignment * Alignment;
+				header.offsets[s] = position;
+				position += header.sizes[s];
+			}
+
+			return header;
+		}
+
+		template<class Y>
+		static std::span<const Y> GetSection(const std::byte* data, const Header& header, Section section)
+		{
+			if (0 == header.sizes[section])
+			{
+				return std::span<const Y>();
+			}
+
+			return std::span<const Y>((const Y*)(data + header.offsets[section]), header.sizes[section] / sizeof(Y));
+		}
+	};
+}
\ No newline at end of file
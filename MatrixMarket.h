@@ -0,0 +1,440 @@
+#pragma once
+
+#include "SparseMatrix.h"
+#include "TripletMatrix.h"
+
+#include "misc/MappedFile.h"
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace spandex
+{
+	class MatrixMarket
+	{
+	public:
+		template<class T, class I = int, class O = I>
+		static SparseMatrix<T, I, O> Read(const std::string& path)
+		{
+			return std::move(Read<T, I, O>(path, nullptr));
+		}
+
+		template<class T, class I = int, class O = I>
+		static SparseMatrix<T, I, O> Read(const std::string& path, misc::ThreadPool& pool)
+		{
+			return std::move(Read<T, I, O>(path, &pool));
+		}
+
+		template<class T, class I, class O>
+		static void Write(const SparseMatrix<T, I, O>& a, const std::string& path)
+		{
+			Write(a, path, nullptr);
+		}
+
+		template<class T, class I, class O>
+		static void Write(const SparseMatrix<T, I, O>& a, const std::string& path, misc::ThreadPool& pool)
+		{
+			Write(a, path, &pool);
+		}
+
+	private:
+		enum Field
+		{
+			Real, Integer, Pattern
+		};
+
+		struct Banner
+		{
+			Field field;
+			bool symmetric;
+			long long rowCount;
+			long long columnCount;
+			long long entryCount;
+			const char* body;
+		};
+
+		template<class T, class I, class O>
+		static SparseMatrix<T, I, O> Read(const std::string& path, misc::ThreadPool* pool)
+		{
+			misc::MappedFile file(path);
+			const char* begin = (const char*)file.GetData();
+			const char* end = begin + file.GetSize();
+
+			Banner banner = ReadBanner(begin, end, path);
+			if (banner.rowCount > (long long)std::numeric_limits<I>::max() ||
+				banner.columnCount > (long long)std::numeric_limits<I>::max() ||
+				banner.entryCount > (long long)std::numeric_limits<O>::max())
+			{
+				throw std::overflow_error("matrix is too large for the index types: " + path);
+			}
+			if (banner.symmetric && banner.rowCount != banner.columnCount)
+			{
+				throw std::runtime_error("symmetric matrix is not square: " + path);
+			}
+
+			int parts = nullptr == pool ? 1 : pool->size;
+			TripletMatrix<T, I, O> triplets((I)banner.rowCount, (I)banner.columnCount, parts);
+
+			std::vector<const char*> bounds(1 + parts, end);
+			long long length = end - banner.body;
+			for (int t = 0; t < parts; t++)
+			{
+				const char* p = banner.body + length * t / parts;
+				while (t > 0 && p < end && '\n' != p[-1])
+				{
+					p++;
+				}
+				bounds[t] = p;
+			}
+
+			std::vector<char> failed(parts, 0);
+			auto parse = [&](int thread)
+				{
+					long long share = (bounds[thread + 1] - bounds[thread]) * banner.entryCount / std::max(1LL, length);
+					triplets.Reserve((O)std::min(share + 16, banner.entryCount), thread);
+
+					failed[thread] = ReadEntries(banner, bounds[thread], bounds[thread + 1], triplets, thread) ? 0 : 1;
+				};
+
+			if (nullptr == pool)
+			{
+				parse(0);
+			}
+			else
+			{
+				pool->Run(parse);
+			}
+
+			if (std::any_of(failed.begin(), failed.end(), [](char f) { return 0 != f; }))
+			{
+				throw std::runtime_error("malformed matrix entry: " + path);
+			}
+			if ((long long)triplets.GetSize() != banner.entryCount)
+			{
+				throw std::runtime_error("expected " + std::to_string(banner.entryCount) + " entries: " + path);
+			}
+
+			auto sparse = triplets.ToMatrix();
+			if (banner.symmetric)
+			{
+				sparse.layout = Layout::LowerSymmetric;
+			}
+
+			return std::move(sparse);
+		}
+
+		static Banner ReadBanner(const char* begin, const char* end, const std::string& path)
+		{
+			const char* p = begin;
+			std::vector<std::string> words;
+			while (p < end && '\n' != *p)
+			{
+				const char* q = SkipSpace(p, end);
+				p = q;
+				while (p < end && !IsSpace(*p) && '\n' != *p)
+				{
+					p++;
+				}
+				if (p > q)
+				{
+					std::string word(q, p);
+					std::transform(word.begin(), word.end(), word.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+					words.push_back(word);
+				}
+			}
+
+			if (5 != words.size() || "%%matrixmarket" != words[0] || "matrix" != words[1])
+			{
+				throw std::runtime_error("not a matrix market file: " + path);
+			}
+			if ("coordinate" != words[2])
+			{
+				throw std::runtime_error("unsupported matrix market format " + words[2] + ": " + path);
+			}
+
+			Banner banner;
+			if ("real" == words[3] || "double" == words[3])
+			{
+				banner.field = Field::Real;
+			}
+			else if ("integer" == words[3])
+			{
+				banner.field = Field::Integer;
+			}
+			else if ("pattern" == words[3])
+			{
+				banner.field = Field::Pattern;
+			}
+			else
+			{
+				throw std::runtime_error("unsupported matrix market field " + words[3] + ": " + path);
+			}
+
+			if ("general" == words[4])
+			{
+				banner.symmetric = false;
+			}
+			else if ("symmetric" == words[4])
+			{
+				banner.symmetric = true;
+			}
+			else
+			{
+				throw std::runtime_error("unsupported matrix market symmetry " + words[4] + ": " + path);
+			}
+
+			while (p < end)
+			{
+				p = SkipSpace(p + 1, end);
+				if (p < end && '%' != *p && '\n' != *p)
+				{
+					break;
+				}
+				while (p < end && '\n' != *p)
+				{
+					p++;
+				}
+			}
+
+			if (!ReadNumber(p, end, banner.rowCount) || !ReadNumber(p, end, banner.columnCount) ||
+				!ReadNumber(p, end, banner.entryCount) || banner.rowCount < 0 || banner.columnCount < 0 || banner.entryCount < 0)
+			{
+				throw std::runtime_error("malformed matrix market size line: " + path);
+			}
+			while (p < end && '\n' != *p)
+			{
+				p++;
+			}
+			banner.body = p;
+
+			return banner;
+		}
+
+		template<class T, class I, class O>
+		static bool ReadEntries(const Banner& banner, const char* p, const char* end, TripletMatrix<T, I, O>& triplets, int thread)
+		{
+			while (p < end)
+			{
+				p = SkipSpace(p, end);
+				if (p == end)
+				{
+					break;
+				}
+				if ('\n' == *p)
+				{
+					p++;
+					continue;
+				}
+				if ('%' == *p)
+				{
+					while (p < end && '\n' != *p)
+					{
+						p++;
+					}
+					continue;
+				}
+
+				long long row;
+				long long column;
+				if (!ReadNumber(p, end, row) || !ReadNumber(p, end, column) ||
+					row < 1 || row > banner.rowCount || column < 1 || column > banner.columnCount)
+				{
+					return false;
+				}
+
+				T value = (T)1;
+				if (Field::Pattern != banner.field && !ReadValue(p, end, banner.field, value))
+				{
+					return false;
+				}
+
+				p = SkipSpace(p, end);
+				if (p < end && '\n' != *p)
+				{
+					return false;
+				}
+
+				if (banner.symmetric && row < column)
+				{
+					std::swap(row, column);
+				}
+				triplets.Insert((I)(row - 1), (I)(column - 1), value, thread);
+			}
+
+			return true;
+		}
+
+		static bool IsSpace(char c)
+		{
+			return ' ' == c || '\t' == c || '\r' == c;
+		}
+
+		static const char* SkipSpace(const char* p, const char* end)
+		{
+			while (p < end && IsSpace(*p))
+			{
+				p++;
+			}
+
+			return p;
+		}
+
+		template<class Y>
+		static bool ReadNumber(const char*& p, const char* end, Y& value)
+		{
+			p = SkipSpace(p, end);
+			if (p < end && '+' == *p)
+			{
+				p++;
+			}
+
+			auto result = std::from_chars(p, end, value);
+			if (std::errc() != result.ec)
+			{
+				return false;
+			}
+
+			p = result.ptr;
+			return p == end || IsSpace(*p) || '\n' == *p;
+		}
+
+		template<class T>
+		static bool ReadValue(const char*& p, const char* end, Field field, T& value)
+		{
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				return ReadNumber(p, end, value);
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				if (Field::Integer == field)
+				{
+					return ReadNumber(p, end, value);
+				}
+
+				double real;
+				if (!ReadNumber(p, end, real))
+				{
+					return false;
+				}
+				value = (T)real;
+				return true;
+			}
+			else
+			{
+				double real;
+				if (!ReadNumber(p, end, real))
+				{
+					return false;
+				}
+				value = (T)real;
+				return true;
+			}
+		}
+
+		template<class T, class I, class O>
+		static void Write(const SparseMatrix<T, I, O>& a, const std::string& path, misc::ThreadPool* pool)
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				throw std::runtime_error("cannot create " + path);
+			}
+
+			bool symmetric = Layout::LowerSymmetric == a.layout || Layout::UpperSymmetric == a.layout;
+			file << "%%MatrixMarket matrix coordinate " << (std::is_integral_v<T> ? "integer" : "real") << " "
+				<< (symmetric ? "symmetric" : "general") << "\n";
+			file << a.rowCount << " " << a.columnCount << " " << a.nnz << "\n";
+
+			int parts = nullptr == pool ? 1 : pool->size;
+			I step = std::max((I)1, (I)(a.columnCount / (64 * parts) + 1));
+			std::vector<std::string> buffers(parts);
+			std::vector<char> failed(parts, 0);
+
+			for (I from = 0; from < a.columnCount; from += step * parts)
+			{
+				auto format = [&](int thread)
+					{
+						I begin = std::min(a.columnCount, (I)(from + step * thread));
+						I end = std::min(a.columnCount, (I)(begin + step));
+						buffers[thread].clear();
+						failed[thread] = WriteEntries(a, begin, end, Layout::UpperSymmetric == a.layout, buffers[thread]) ? 0 : 1;
+					};
+
+				if (nullptr == pool)
+				{
+					format(0);
+				}
+				else
+				{
+					pool->Run(format);
+				}
+
+				if (std::any_of(failed.begin(), failed.end(), [](char f) { return 0 != f; }))
+				{
+					throw std::runtime_error("cannot format matrix entry: " + path);
+				}
+
+				for (auto& buffer : buffers)
+				{
+					file.write(buffer.data(), buffer.size());
+				}
+			}
+
+			if (!file)
+			{
+				throw std::runtime_error("cannot write " + path);
+			}
+		}
+
+		template<class T, class I, class O>
+		static bool WriteEntries(const SparseMatrix<T, I, O>& a, I from, I to, bool transpose, std::string& buffer)
+		{
+			char line[96];
+			char* last = line + sizeof(line) - 1;
+
+			auto put = [&](char*& p, auto value, char separator)
+			{
+				auto [ptr, ec] = std::to_chars(p, last, value);
+				if (std::errc() != ec)
+				{
+					return false;
+				}
+
+				*ptr = separator;
+				p = ptr + 1;
+				return true;
+			};
+
+			for (I j = from; j < to; j++)
+			{
+				for (O k = a.columns[j]; k < a.columns[j + 1]; k++)
+				{
+					long long row = (long long)a.columnsRows[k] + 1;
+					long long column = (long long)j + 1;
+					if (transpose)
+					{
+						std::swap(row, column);
+					}
+
+					char* p = line;
+					if (!put(p, row, ' ') || !put(p, column, ' ') || !put(p, a.values[k], '\n'))
+					{
+						return false;
+					}
+					buffer.append(line, p);
+				}
+			}
+
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,722 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace spandex
+{
+	template<class I, class O = I>
+	class BasicMinimumDegree
+	{
+	private:
+		constexpr static I NIL = -1;
+
+		I n;
+		I count;
+		I dense;
+		std::vector<I> iw;
+		std::vector<O> pe;
+		std::vector<I> len;
+		std::vector<I> elen;
+		std::vector<I> nv;
+		std::vector<I> degree;
+		std::vector<I> head;
+		std::vector<I> next;
+		std::vector<I> last;
+		std::vector<I> bucket;
+		std::vector<I> w;
+		O pfree;
+		I wflg;
+		I wbig;
+		I lemax;
+
+		BasicMinimumDegree(I n, I count) : n(n), count(count), dense(n),
+			pe(count, NIL), len(count, 0), elen(count, 0), nv(count, 1), degree(count, 0), head(n, NIL), next(n, NIL), last(n, NIL), bucket(n, NIL), w(count, 1)
+		{
+			pfree = 0;
+			wbig = std::numeric_limits<I>::max() - count;
+			wflg = 0;
+			lemax = 0;
+		}
+
+	public:
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency)
+		{
+			assert(n + 1 == (I)starts.size());
+
+			BasicMinimumDegree<I, O> md(n, n);
+			md.dense = std::min(n, std::max((I)16, (I)(10 * std::sqrt((double)n))));
+
+			O nnz = starts[n];
+			md.iw.resize((size_t)nnz + nnz / 5 + 2 * (size_t)n + 1);
+			std::copy(adjacency.begin(), adjacency.begin() + nnz, md.iw.begin());
+
+			for (I i = 0; i < n; i++)
+			{
+				md.pe[i] = starts[i];
+				md.len[i] = (I)(starts[i + 1] - starts[i]);
+				md.degree[i] = md.len[i];
+			}
+			md.pfree = nnz;
+
+			md.Eliminate();
+
+			return std::move(md.BuildOrder());
+		}
+
+		static std::vector<I> OrderColumns(I rowCount, I columnCount, const std::vector<O>& columns, const std::vector<I>& columnsRows)
+		{
+			assert(columnCount + 1 == (I)columns.size());
+
+			I m = rowCount;
+			I n = columnCount;
+			BasicMinimumDegree<I, O> md(n, n + m);
+
+			I denseRow = std::min(n, std::max((I)16, (I)(10 * std::sqrt((double)n))));
+			I denseColumn = std::min(m, std::max((I)16, (I)(10 * std::sqrt((double)std::min(m, n)))));
+
+			std::vector<I> mark(m, NIL);
+			std::vector<I> rowCounts(m, 0);
+			for (I j = 0; j < n; j++)
+			{
+				for (O p = columns[j]; p < columns[j + 1]; p++)
+				{
+					I r = columnsRows[p];
+					if (j != mark[r])
+					{
+						mark[r] = j;
+						rowCounts[r]++;
+					}
+				}
+			}
+
+			O nnz = 0;
+			for (I j = 0; j < n; j++)
+			{
+				I c = 0;
+				for (O p = columns[j]; p < columns[j + 1]; p++)
+				{
+					I r = columnsRows[p];
+					if (rowCounts[r] <= denseRow && Flip(j) != mark[r])
+					{
+						mark[r] = Flip(j);
+						c++;
+					}
+				}
+
+				if (c > denseColumn)
+				{
+					md.nv[j] = 0;
+					md.elen[j] = NIL;
+					continue;
+				}
+
+				md.len[j] = c;
+				md.elen[j] = c;
+				for (O p = columns[j]; p < columns[j + 1]; p++)
+				{
+					I r = columnsRows[p];
+					if (rowCounts[r] <= denseRow && Flip(j) == mark[r])
+					{
+						mark[r] = j;
+						md.len[n + r]++;
+					}
+				}
+				nnz += 2 * c;
+			}
+
+			md.iw.resize((size_t)nnz + nnz / 5 + 2 * (size_t)n + 1);
+
+			O start = 0;
+			for (I j = 0; j < n + m; j++)
+			{
+				if (md.len[j] > 0)
+				{
+					md.pe[j] = start;
+					start += md.len[j];
+				}
+			}
+			md.pfree = start;
+
+			std::fill(mark.begin(), mark.end(), NIL);
+			std::vector<O> fill(m);
+			for (I r = 0; r < m; r++)
+			{
+				fill[r] = md.pe[n + r];
+				md.degree[n + r] = md.len[n + r];
+				md.lemax = std::max(md.lemax, md.len[n + r]);
+				md.nv[n + r] = 0;
+				md.elen[n + r] = NIL;
+				if (0 == md.len[n + r])
+				{
+					md.w[n + r] = 0;
+				}
+			}
+
+			for (I j = 0; j < n; j++)
+			{
+				if (0 == md.len[j])
+				{
+					continue;
+				}
+
+				O q = md.pe[j];
+				I deg = 0;
+				for (O p = columns[j]; p < columns[j + 1]; p++)
+				{
+					I r = columnsRows[p];
+					if (rowCounts[r] <= denseRow && j != mark[r])
+					{
+						mark[r] = j;
+						md.iw[q++] = n + r;
+						md.iw[fill[r]++] = j;
+						deg = std::min(n - 1, deg + md.len[n + r] - 1);
+					}
+				}
+				md.degree[j] = deg;
+			}
+
+			md.Eliminate();
+
+			return std::move(md.BuildOrder());
+		}
+
+	private:
+		static I Flip(I i)
+		{
+			return -i - 2;
+		}
+
+		void ClearFlag()
+		{
+			if (wflg < 2 || wflg >= wbig)
+			{
+				for (I x = 0; x < count; x++)
+				{
+					if (0 != w[x])
+					{
+						w[x] = 1;
+					}
+				}
+				wflg = 2;
+			}
+		}
+
+		void Unlink(I i)
+		{
+			I ilast = last[i];
+			I inext = next[i];
+			if (NIL != inext)
+			{
+				last[inext] = ilast;
+			}
+			if (NIL != ilast)
+			{
+				next[ilast] = inext;
+			}
+			else
+			{
+				head[degree[i]] = inext;
+			}
+		}
+
+		void Link(I i, I deg)
+		{
+			I inext = head[deg];
+			if (NIL != inext)
+			{
+				last[inext] = i;
+			}
+			next[i] = inext;
+			last[i] = NIL;
+			head[deg] = i;
+		}
+
+		O Compress(O pme1)
+		{
+			for (I j = 0; j < count; j++)
+			{
+				O pn = pe[j];
+				if (pn >= 0)
+				{
+					pe[j] = iw[pn];
+					iw[pn] = Flip(j);
+				}
+			}
+
+			O psrc = 0;
+			O pdst = 0;
+			while (psrc < pme1)
+			{
+				I j = Flip(iw[psrc++]);
+				if (j >= 0)
+				{
+					iw[pdst] = (I)pe[j];
+					pe[j] = pdst++;
+					for (I k = 1; k < len[j]; k++)
+					{
+						iw[pdst++] = iw[psrc++];
+					}
+				}
+			}
+
+			O p1 = pdst;
+			for (psrc = pme1; psrc < pfree; psrc++)
+			{
+				iw[pdst++] = iw[psrc];
+			}
+			pfree = pdst;
+
+			return p1;
+		}
+
+		void Eliminate()
+		{
+			I nel = 0;
+			I mindeg = 0;
+
+			ClearFlag();
+
+			for (I i = 0; i < n; i++)
+			{
+				if (0 == nv[i])
+				{
+					nel += 1;
+				}
+				else if (0 == degree[i])
+				{
+					elen[i] = Flip(1);
+					nel += 1;
+					pe[i] = NIL;
+					w[i] = 0;
+				}
+				else if (degree[i] > dense)
+				{
+					nv[i] = 0;
+					elen[i] = NIL;
+					nel += 1;
+					pe[i] = NIL;
+				}
+				else
+				{
+					Link(i, degree[i]);
+				}
+			}
+
+			while (nel < n)
+			{
+				I deg = mindeg;
+				I me = NIL;
+				for (; deg < n; deg++)
+				{
+					me = head[deg];
+					if (NIL != me)
+					{
+						break;
+					}
+				}
+				mindeg = deg;
+
+				I inext = next[me];
+				if (NIL != inext)
+				{
+					last[inext] = NIL;
+				}
+				head[deg] = inext;
+
+				I elenme = elen[me];
+				I nvpiv = nv[me];
+				nel += nvpiv;
+
+				nv[me] = -nvpiv;
+				I degme = 0;
+				O pme1;
+				O pme2;
+
+				if (0 == elenme)
+				{
+					pme1 = pe[me];
+					pme2 = pme1 - 1;
+					for (O p = pme1; p < pme1 + len[me]; p++)
+					{
+						I i = iw[p];
+						I nvi = nv[i];
+						if (nvi > 0)
+						{
+							degme += nvi;
+							nv[i] = -nvi;
+							iw[++pme2] = i;
+							Unlink(i);
+						}
+					}
+				}
+				else
+				{
+					O p = pe[me];
+					pme1 = pfree;
+					I slenme = len[me] - elenme;
+
+					for (I knt1 = 1; knt1 <= elenme + 1; knt1++)
+					{
+						I e;
+						O pj;
+						I ln;
+						if (knt1 > elenme)
+						{
+							e = me;
+							pj = p;
+							ln = slenme;
+						}
+						else
+						{
+							e = iw[p++];
+							pj = pe[e];
+							ln = len[e];
+						}
+
+						for (I knt2 = 1; knt2 <= ln; knt2++)
+						{
+							I i = iw[pj++];
+							I nvi = nv[i];
+							if (nvi <= 0)
+							{
+								continue;
+							}
+
+							if (pfree >= (O)iw.size())
+							{
+								pe[me] = p;
+								len[me] -= knt1;
+								if (0 == len[me])
+								{
+									pe[me] = NIL;
+								}
+								pe[e] = pj;
+								len[e] = ln - knt2;
+								if (0 == len[e])
+								{
+									pe[e] = NIL;
+								}
+
+								pme1 = Compress(pme1);
+
+								pj = pe[e];
+								p = pe[me];
+							}
+
+							degme += nvi;
+							nv[i] = -nvi;
+							iw[pfree++] = i;
+							Unlink(i);
+						}
+
+						if (e != me)
+						{
+							pe[e] = Flip(me);
+							w[e] = 0;
+						}
+					}
+
+					pme2 = pfree - 1;
+				}
+
+				degree[me] = degme;
+				pe[me] = pme1;
+				len[me] = (I)(pme2 - pme1 + 1);
+				elen[me] = Flip(nvpiv + degme);
+
+				ClearFlag();
+
+				for (O pme = pme1; pme <= pme2; pme++)
+				{
+					I i = iw[pme];
+					I eln = elen[i];
+					if (eln <= 0)
+					{
+						continue;
+					}
+
+					I nvi = -nv[i];
+					I wnvi = wflg - nvi;
+					for (O p = pe[i]; p < pe[i] + eln; p++)
+					{
+						I e = iw[p];
+						I we = w[e];
+						if (we >= wflg)
+						{
+							we -= nvi;
+						}
+						else if (0 != we)
+						{
+							we = degree[e] + wnvi;
+						}
+						w[e] = we;
+					}
+				}
+
+				for (O pme = pme1; pme <= pme2; pme++)
+				{
+					I i = iw[pme];
+					O p1 = pe[i];
+					O p2 = p1 + elen[i] - 1;
+					O pn = p1;
+					unsigned long long hash = 0;
+					I deg = 0;
+
+					for (O p = p1; p <= p2; p++)
+					{
+						I e = iw[p];
+						I we = w[e];
+						if (0 == we)
+						{
+							continue;
+						}
+
+						I dext = we - wflg;
+						if (dext > 0)
+						{
+							deg += dext;
+							iw[pn++] = e;
+							hash += e;
+						}
+						else
+						{
+							pe[e] = Flip(me);
+							w[e] = 0;
+						}
+					}
+
+					elen[i] = (I)(pn - p1 + 1);
+					O p3 = pn;
+					O p4 = p1 + len[i];
+					for (O p = p2 + 1; p < p4; p++)
+					{
+						I j = iw[p];
+						I nvj = nv[j];
+						if (nvj > 0)
+						{
+							deg += nvj;
+							iw[pn++] = j;
+							hash += j;
+						}
+					}
+
+					if (1 == elen[i] && p3 == pn)
+					{
+						pe[i] = Flip(me);
+						I nvi = -nv[i];
+						degme -= nvi;
+						nvpiv += nvi;
+						nel += nvi;
+						nv[i] = 0;
+						elen[i] = NIL;
+					}
+					else
+					{
+						degree[i] = std::min(degree[i], deg);
+
+						iw[pn] = iw[p3];
+						iw[p3] = iw[p1];
+						iw[p1] = me;
+						len[i] = (I)(pn - p1 + 1);
+
+						I h = (I)(hash % n);
+						next[i] = bucket[h];
+						bucket[h] = i;
+						last[i] = h;
+					}
+				}
+
+				degree[me] = degme;
+				lemax = std::max(lemax, degme);
+				wflg += lemax;
+				ClearFlag();
+
+				for (O pme = pme1; pme <= pme2; pme++)
+				{
+					I i = iw[pme];
+					if (nv[i] >= 0)
+					{
+						continue;
+					}
+
+					I h = last[i];
+					i = bucket[h];
+					bucket[h] = NIL;
+
+					while (NIL != i && NIL != next[i])
+					{
+						I ln = len[i];
+						I eln = elen[i];
+						for (O p = pe[i] + 1; p < pe[i] + ln; p++)
+						{
+							w[iw[p]] = wflg;
+						}
+
+						I jlast = i;
+						I j = next[i];
+						while (NIL != j)
+						{
+							bool same = len[j] == ln && elen[j] == eln;
+							for (O p = pe[j] + 1; same && p < pe[j] + ln; p++)
+							{
+								same = w[iw[p]] == wflg;
+							}
+
+							if (same)
+							{
+								pe[j] = Flip(i);
+								nv[i] += nv[j];
+								nv[j] = 0;
+								elen[j] = NIL;
+								j = next[j];
+								next[jlast] = j;
+							}
+							else
+							{
+								jlast = j;
+								j = next[j];
+							}
+						}
+
+						wflg += 1;
+						i = next[i];
+					}
+				}
+
+				O p = pme1;
+				I nleft = n - nel;
+				for (O pme = pme1; pme <= pme2; pme++)
+				{
+					I i = iw[pme];
+					I nvi = -nv[i];
+					if (nvi <= 0)
+					{
+						continue;
+					}
+
+					nv[i] = nvi;
+					I deg = std::min(degree[i] + degme - nvi, nleft - nvi);
+					Link(i, deg);
+					mindeg = std::min(mindeg, deg);
+					degree[i] = deg;
+					iw[p++] = i;
+				}
+
+				nv[me] = nvpiv;
+				len[me] = (I)(p - pme1);
+				if (0 == len[me])
+				{
+					pe[me] = NIL;
+					w[me] = 0;
+				}
+				if (0 != elenme)
+				{
+					pfree = p;
+				}
+			}
+		}
+
+		std::vector<I> BuildOrder()
+		{
+			std::vector<I> parent(n);
+			for (I i = 0; i < n; i++)
+			{
+				parent[i] = pe[i] < 0 ? Flip((I)pe[i]) : NIL;
+			}
+
+			for (I i = 0; i < n; i++)
+			{
+				if (0 != nv[i] || NIL == parent[i])
+				{
+					continue;
+				}
+
+				I e = parent[i];
+				while (0 == nv[e])
+				{
+					e = parent[e];
+				}
+				for (I j = i; 0 == nv[j];)
+				{
+					I jnext = parent[j];
+					parent[j] = e;
+					j = jnext;
+				}
+			}
+
+			std::vector<I>& child = head;
+			std::vector<I>& sibling = next;
+			std::fill(child.begin(), child.end(), NIL);
+			std::fill(sibling.begin(), sibling.end(), NIL);
+			for (I j = n - 1; j >= 0; j--)
+			{
+				if (nv[j] > 0 && NIL != parent[j])
+				{
+					sibling[j] = child[parent[j]];
+					child[parent[j]] = j;
+				}
+			}
+
+			std::vector<I>& start = w;
+			std::vector<I> stack;
+			I k = 0;
+			for (I root = 0; root < n; root++)
+			{
+				if (nv[root] <= 0 || NIL != parent[root])
+				{
+					continue;
+				}
+
+				stack.push_back(root);
+				while (!stack.empty())
+				{
+					I e = stack.back();
+					I c = child[e];
+					if (NIL != c)
+					{
+						child[e] = sibling[c];
+						stack.push_back(c);
+						continue;
+					}
+
+					stack.pop_back();
+					start[e] = k;
+					k += nv[e];
+				}
+			}
+
+			std::vector<I> order(n);
+			for (I i = 0; i < n; i++)
+			{
+				if (0 != nv[i])
+				{
+					continue;
+				}
+
+				if (NIL != parent[i])
+				{
+					order[start[parent[i]]++] = i;
+				}
+				else
+				{
+					order[k++] = i;
+				}
+			}
+			for (I i = 0; i < n; i++)
+			{
+				if (nv[i] > 0)
+				{
+					order[start[i]] = i;
+				}
+			}
+
+			return std::move(order);
+		}
+	};
+
+	using MinimumDegree = BasicMinimumDegree<int>;
+}
\ No newline at end of file
@@ -0,0 +1,791 @@
+#pragma once
+
+#include "MinimumDegree.h"
+
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace spandex
+{
+	template<class I, class O = I>
+	class BasicNestedDissection
+	{
+	private:
+		constexpr static I NIL = -1;
+		constexpr static I LeafSize = 200;
+		constexpr static I CoarsestSize = 64;
+		constexpr static int PassCount = 8;
+		constexpr static int StallCount = 64;
+
+		struct Graph
+		{
+			std::vector<O> starts;
+			std::vector<I> adjacency;
+			std::vector<I> edgeWeights;
+			std::vector<I> weights;
+
+			I GetSize() const
+			{
+				return (I)weights.size();
+			}
+
+			long long GetWeight() const
+			{
+				return std::accumulate(weights.begin(), weights.end(), 0LL);
+			}
+		};
+
+		struct Task
+		{
+			std::vector<I> vertices;
+			I position;
+		};
+
+		struct Workspace
+		{
+			std::vector<I> local;
+			std::minstd_rand random;
+
+			Workspace(I n) : local(n, NIL)
+			{
+			}
+		};
+
+		using Entry = std::pair<long long, I>;
+		using Queue = std::priority_queue<Entry>;
+
+		I n;
+		const std::vector<O>& starts;
+		const std::vector<I>& adjacency;
+		std::vector<I> order;
+
+		BasicNestedDissection(I n, const std::vector<O>& starts, const std::vector<I>& adjacency) : n(n),
+			starts(starts), adjacency(adjacency), order(n, NIL)
+		{
+			assert(n + 1 == (I)starts.size());
+		}
+
+	public:
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency)
+		{
+			return std::move(Order(n, starts, adjacency, nullptr));
+		}
+
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency, misc::ThreadPool& pool)
+		{
+			return std::move(Order(n, starts, adjacency, &pool));
+		}
+
+	private:
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency, misc::ThreadPool* pool)
+		{
+			BasicNestedDissection<I, O> nd(n, starts, adjacency);
+
+			I dense = std::max((I)16, (I)(10 * std::sqrt((double)n)));
+			std::vector<I> denses;
+			std::vector<Task> tasks(1);
+			tasks[0].position = 0;
+			for (I v = 0; v < n; v++)
+			{
+				if ((I)(starts[v + 1] - starts[v]) > dense)
+				{
+					denses.push_back(v);
+				}
+				else
+				{
+					tasks[0].vertices.push_back(v);
+				}
+			}
+
+			std::stable_sort(denses.begin(), denses.end(), [&](I x, I y) { return starts[x + 1] - starts[x] < starts[y + 1] - starts[y]; });
+			I top = n - (I)denses.size();
+			for (I v : denses)
+			{
+				nd.order[top++] = v;
+			}
+
+			int parts = nullptr == pool ? 1 : pool->size;
+			std::vector<Workspace> workspaces(parts, Workspace(n));
+
+			if (1 == parts)
+			{
+				nd.Dissect(std::move(tasks[0]), workspaces[0]);
+				return std::move(nd.order);
+			}
+
+			while (!tasks.empty() && (int)tasks.size() < 4 * parts)
+			{
+				auto largest = std::max_element(tasks.begin(), tasks.end(),
+					[](const Task& x, const Task& y) { return x.vertices.size() < y.vertices.size(); });
+				if (largest->vertices.size() <= (size_t)LeafSize)
+				{
+					break;
+				}
+
+				Task task = std::move(*largest);
+				tasks.erase(largest);
+				nd.Split(task, workspaces[0], tasks);
+			}
+
+			std::atomic<size_t> next(0);
+			pool->Run([&](int thread)
+				{
+					for (size_t k = next++; k < tasks.size(); k = next++)
+					{
+						nd.Dissect(std::move(tasks[k]), workspaces[thread]);
+					}
+				});
+
+			return std::move(nd.order);
+		}
+
+		void Dissect(Task&& task, Workspace& ws)
+		{
+			std::vector<Task> stack;
+			stack.push_back(std::move(task));
+
+			while (!stack.empty())
+			{
+				Task top = std::move(stack.back());
+				stack.pop_back();
+
+				Split(top, ws, stack);
+			}
+		}
+
+		void Split(const Task& task, Workspace& ws, std::vector<Task>& tasks)
+		{
+			ws.random.seed((unsigned)task.position * 2654435761u + (unsigned)task.vertices.size());
+
+			Graph g;
+			Extract(task.vertices, ws, g);
+
+			if (g.GetSize() <= LeafSize)
+			{
+				Leaf(task, g);
+				return;
+			}
+
+			std::vector<char> side;
+			Bisect(g, ws, side);
+
+			I counts[3] = { 0, 0, 0 };
+			for (char s : side)
+			{
+				counts[(int)s] += 1;
+			}
+			if (0 == counts[0] || 0 == counts[1])
+			{
+				Leaf(task, g);
+				return;
+			}
+
+			Task parts[2];
+			parts[0].position = task.position;
+			parts[1].position = task.position + counts[0];
+			parts[0].vertices.reserve(counts[0]);
+			parts[1].vertices.reserve(counts[1]);
+
+			I s = task.position + counts[0] + counts[1];
+			for (I k = 0; k < g.GetSize(); k++)
+			{
+				if (2 == side[k])
+				{
+					order[s++] = task.vertices[k];
+				}
+				else
+				{
+					parts[(int)side[k]].vertices.push_back(task.vertices[k]);
+				}
+			}
+
+			tasks.push_back(std::move(parts[1]));
+			tasks.push_back(std::move(parts[0]));
+		}
+
+		void Leaf(const Task& task, const Graph& g)
+		{
+			auto local = BasicMinimumDegree<I, O>::Order(g.GetSize(), g.starts, g.adjacency);
+			for (I k = 0; k < g.GetSize(); k++)
+			{
+				order[task.position + k] = task.vertices[local[k]];
+			}
+		}
+
+		void Extract(const std::vector<I>& vertices, Workspace& ws, Graph& g) const
+		{
+			I size = (I)vertices.size();
+			for (I k = 0; k < size; k++)
+			{
+				ws.local[vertices[k]] = k;
+			}
+
+			g.starts.assign(1, 0);
+			g.adjacency.clear();
+			for (I k = 0; k < size; k++)
+			{
+				I v = vertices[k];
+				for (O p = starts[v]; p < starts[v + 1]; p++)
+				{
+					I u = ws.local[adjacency[p]];
+					if (NIL != u)
+					{
+						g.adjacency.push_back(u);
+					}
+				}
+				g.starts.push_back((O)g.adjacency.size());
+			}
+			g.edgeWeights.assign(g.adjacency.size(), 1);
+			g.weights.assign(size, 1);
+
+			for (I k = 0; k < size; k++)
+			{
+				ws.local[vertices[k]] = NIL;
+			}
+		}
+
+		static void Bisect(const Graph& g, Workspace& ws, std::vector<char>& side)
+		{
+			std::vector<Graph> levels;
+			std::vector<std::vector<I>> maps;
+			auto level = [&](size_t l) -> const Graph& { return 0 == l ? g : levels[l - 1]; };
+
+			while (level(levels.size()).GetSize() > CoarsestSize)
+			{
+				const Graph& fine = level(levels.size());
+
+				Graph coarse;
+				std::vector<I> map;
+				Coarsen(fine, ws, map, coarse);
+				if ((long long)coarse.GetSize() * 10 > (long long)fine.GetSize() * 9)
+				{
+					break;
+				}
+
+				levels.push_back(std::move(coarse));
+				maps.push_back(std::move(map));
+			}
+
+			InitialBisection(level(levels.size()), ws, side);
+
+			for (size_t l = levels.size(); l > 0; l--)
+			{
+				const std::vector<I>& map = maps[l - 1];
+				std::vector<char> fine(map.size());
+				for (size_t v = 0; v < map.size(); v++)
+				{
+					fine[v] = side[map[v]];
+				}
+				side = std::move(fine);
+
+				RefineEdges(level(l - 1), side);
+			}
+
+			BuildSeparator(g, side);
+			RefineSeparator(g, side);
+		}
+
+		static void Coarsen(const Graph& g, Workspace& ws, std::vector<I>& map, Graph& coarse)
+		{
+			I size = g.GetSize();
+			long long maxWeight = std::max(1LL, 3 * g.GetWeight() / (2 * CoarsestSize));
+
+			std::vector<I> visit(size);
+			std::iota(visit.begin(), visit.end(), (I)0);
+			std::shuffle(visit.begin(), visit.end(), ws.random);
+
+			std::vector<I> match(size, NIL);
+			std::vector<I> members;
+			map.assign(size, NIL);
+
+			for (I v : visit)
+			{
+				if (NIL != match[v])
+				{
+					continue;
+				}
+
+				I best = v;
+				I bestWeight = 0;
+				for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+				{
+					I u = g.adjacency[p];
+					if (NIL == match[u] && u != v && g.edgeWeights[p] > bestWeight &&
+						(long long)g.weights[v] + g.weights[u] <= maxWeight)
+					{
+						best = u;
+						bestWeight = g.edgeWeights[p];
+					}
+				}
+
+				match[v] = best;
+				match[best] = v;
+				map[v] = map[best] = (I)(members.size() / 2);
+				members.push_back(v);
+				members.push_back(best);
+			}
+
+			I count = (I)(members.size() / 2);
+			coarse.starts.assign(1, 0);
+			coarse.adjacency.clear();
+			coarse.edgeWeights.clear();
+			coarse.weights.assign(count, 0);
+
+			std::vector<O> slot(count, NIL);
+			for (I c = 0; c < count; c++)
+			{
+				O begin = (O)coarse.adjacency.size();
+				for (int m = 0; m < 2; m++)
+				{
+					I v = members[2 * c + m];
+					if (1 == m && v == members[2 * c])
+					{
+						break;
+					}
+
+					coarse.weights[c] += g.weights[v];
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I cu = map[g.adjacency[p]];
+						if (cu == c)
+						{
+							continue;
+						}
+
+						if (NIL == slot[cu] || slot[cu] < begin)
+						{
+							slot[cu] = (O)coarse.adjacency.size();
+							coarse.adjacency.push_back(cu);
+							coarse.edgeWeights.push_back(g.edgeWeights[p]);
+						}
+						else
+						{
+							coarse.edgeWeights[slot[cu]] += g.edgeWeights[p];
+						}
+					}
+				}
+				coarse.starts.push_back((O)coarse.adjacency.size());
+			}
+		}
+
+		static void InitialBisection(const Graph& g, Workspace& ws, std::vector<char>& side)
+		{
+			I size = g.GetSize();
+			long long half = g.GetWeight() / 2;
+
+			long long bestCut = -1;
+			long long bestImbalance = 0;
+			std::vector<char> trial;
+			std::vector<char> visited;
+			std::vector<I> queue;
+
+			for (int t = 0; t < 4; t++)
+			{
+				I seed = 0 == t ? FindPeripheral(g, 0) : (I)(ws.random() % size);
+
+				trial.assign(size, 1);
+				visited.assign(size, 0);
+				queue.clear();
+
+				long long grown = 0;
+				size_t head = 0;
+				I scan = 0;
+				queue.push_back(seed);
+				visited[seed] = 1;
+				while (grown < half)
+				{
+					if (head == queue.size())
+					{
+						while (scan < size && visited[scan])
+						{
+							scan++;
+						}
+						if (scan == size)
+						{
+							break;
+						}
+						queue.push_back(scan);
+						visited[scan] = 1;
+					}
+
+					I v = queue[head++];
+					trial[v] = 0;
+					grown += g.weights[v];
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I u = g.adjacency[p];
+						if (!visited[u])
+						{
+							visited[u] = 1;
+							queue.push_back(u);
+						}
+					}
+				}
+
+				RefineEdges(g, trial);
+
+				long long cut = 0;
+				long long weights[2] = { 0, 0 };
+				for (I v = 0; v < size; v++)
+				{
+					weights[(int)trial[v]] += g.weights[v];
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						if (trial[v] != trial[g.adjacency[p]])
+						{
+							cut += g.edgeWeights[p];
+						}
+					}
+				}
+				long long imbalance = std::abs(weights[0] - weights[1]);
+
+				if (bestCut < 0 || cut < bestCut || (cut == bestCut && imbalance < bestImbalance))
+				{
+					bestCut = cut;
+					bestImbalance = imbalance;
+					side = trial;
+				}
+			}
+		}
+
+		static I FindPeripheral(const Graph& g, I start)
+		{
+			std::vector<I> distance(g.GetSize(), NIL);
+			std::vector<I> queue;
+
+			I far = start;
+			for (int sweep = 0; sweep < 2; sweep++)
+			{
+				std::fill(distance.begin(), distance.end(), NIL);
+				queue.assign(1, far);
+				distance[far] = 0;
+				for (size_t head = 0; head < queue.size(); head++)
+				{
+					I v = queue[head];
+					far = v;
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I u = g.adjacency[p];
+						if (NIL == distance[u])
+						{
+							distance[u] = distance[v] + 1;
+							queue.push_back(u);
+						}
+					}
+				}
+			}
+
+			return far;
+		}
+
+		static void RefineEdges(const Graph& g, std::vector<char>& side)
+		{
+			I size = g.GetSize();
+			long long total = g.GetWeight();
+			long long heaviest = *std::max_element(g.weights.begin(), g.weights.end());
+			long long limit = total / 2 + std::max(total * 3 / 100, heaviest);
+
+			std::vector<long long> gain(size);
+			std::vector<char> locked(size);
+			std::vector<I> moves;
+
+			for (int pass = 0; pass < PassCount; pass++)
+			{
+				long long weights[2] = { 0, 0 };
+				long long cut = 0;
+				Queue queue;
+				for (I v = 0; v < size; v++)
+				{
+					weights[(int)side[v]] += g.weights[v];
+
+					long long external = 0;
+					long long internal = 0;
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						if (side[v] != side[g.adjacency[p]])
+						{
+							external += g.edgeWeights[p];
+						}
+						else
+						{
+							internal += g.edgeWeights[p];
+						}
+					}
+
+					gain[v] = external - internal;
+					cut += external;
+					if (external > 0)
+					{
+						queue.push(Entry(gain[v], v));
+					}
+				}
+				cut /= 2;
+
+				std::fill(locked.begin(), locked.end(), 0);
+				moves.clear();
+
+				long long bestCut = cut;
+				long long bestImbalance = std::abs(weights[0] - weights[1]);
+				size_t best = 0;
+
+				while (!queue.empty())
+				{
+					Entry entry = queue.top();
+					queue.pop();
+
+					I v = entry.second;
+					if (locked[v] || entry.first != gain[v])
+					{
+						continue;
+					}
+
+					int to = 1 - side[v];
+					if (weights[to] + g.weights[v] > limit)
+					{
+						continue;
+					}
+
+					side[v] = (char)to;
+					weights[to] += g.weights[v];
+					weights[1 - to] -= g.weights[v];
+					cut -= gain[v];
+					gain[v] = -gain[v];
+					locked[v] = 1;
+					moves.push_back(v);
+
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I u = g.adjacency[p];
+						gain[u] += side[u] == to ? -2 * (long long)g.edgeWeights[p] : 2 * (long long)g.edgeWeights[p];
+						if (!locked[u])
+						{
+							queue.push(Entry(gain[u], u));
+						}
+					}
+
+					long long imbalance = std::abs(weights[0] - weights[1]);
+					if (cut < bestCut || (cut == bestCut && imbalance < bestImbalance))
+					{
+						bestCut = cut;
+						bestImbalance = imbalance;
+						best = moves.size();
+					}
+					else if (moves.size() - best > (size_t)StallCount)
+					{
+						break;
+					}
+				}
+
+				for (size_t k = moves.size(); k > best; k--)
+				{
+					I v = moves[k - 1];
+					side[v] = (char)(1 - side[v]);
+				}
+
+				if (0 == best)
+				{
+					break;
+				}
+			}
+		}
+
+		static void BuildSeparator(const Graph& g, std::vector<char>& side)
+		{
+			I size = g.GetSize();
+
+			long long boundary[2] = { 0, 0 };
+			for (I v = 0; v < size; v++)
+			{
+				for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+				{
+					if (side[v] != side[g.adjacency[p]])
+					{
+						boundary[(int)side[v]] += g.weights[v];
+						break;
+					}
+				}
+			}
+
+			char cover = boundary[0] <= boundary[1] ? 0 : 1;
+			std::vector<I> separator;
+			for (I v = 0; v < size; v++)
+			{
+				if (cover != side[v])
+				{
+					continue;
+				}
+
+				for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+				{
+					if (side[v] != side[g.adjacency[p]])
+					{
+						separator.push_back(v);
+						break;
+					}
+				}
+			}
+
+			for (I v : separator)
+			{
+				side[v] = 2;
+			}
+		}
+
+		static void RefineSeparator(const Graph& g, std::vector<char>& side)
+		{
+			I size = g.GetSize();
+
+			std::vector<long long> inside[2] = { std::vector<long long>(size), std::vector<long long>(size) };
+			std::vector<char> locked(size);
+			std::vector<std::pair<I, char>> history;
+
+			for (int pass = 0; pass < PassCount; pass++)
+			{
+				long long weights[3] = { 0, 0, 0 };
+				Queue queues[2];
+				std::fill(inside[0].begin(), inside[0].end(), 0);
+				std::fill(inside[1].begin(), inside[1].end(), 0);
+				for (I v = 0; v < size; v++)
+				{
+					weights[(int)side[v]] += g.weights[v];
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I u = g.adjacency[p];
+						if (2 != side[u])
+						{
+							inside[(int)side[u]][v] += g.weights[u];
+						}
+					}
+				}
+				for (I v = 0; v < size; v++)
+				{
+					if (2 == side[v])
+					{
+						queues[0].push(Entry(g.weights[v] - inside[1][v], v));
+						queues[1].push(Entry(g.weights[v] - inside[0][v], v));
+					}
+				}
+
+				long long limit = std::max(std::max(weights[0], weights[1]), (weights[0] + weights[1] + weights[2]) * 11 / 20);
+
+				std::fill(locked.begin(), locked.end(), 0);
+				history.clear();
+
+				auto assign = [&](I v, char to)
+					{
+						char from = side[v];
+						history.push_back(std::make_pair(v, from));
+						side[v] = to;
+						weights[(int)from] -= g.weights[v];
+						weights[(int)to] += g.weights[v];
+
+						if (2 == to && !locked[v])
+						{
+							queues[0].push(Entry(g.weights[v] - inside[1][v], v));
+							queues[1].push(Entry(g.weights[v] - inside[0][v], v));
+						}
+
+						for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+						{
+							I u = g.adjacency[p];
+							if (2 != from)
+							{
+								inside[(int)from][u] -= g.weights[v];
+							}
+							if (2 != to)
+							{
+								inside[(int)to][u] += g.weights[v];
+							}
+							if (2 == side[u] && !locked[u])
+							{
+								int changed = 2 != from ? 1 - from : 1 - to;
+								queues[changed].push(Entry(g.weights[u] - inside[1 - changed][u], u));
+								if (2 != from && 2 != to)
+								{
+									queues[1 - changed].push(Entry(g.weights[u] - inside[changed][u], u));
+								}
+							}
+						}
+					};
+
+				long long bestSeparator = weights[2];
+				long long bestImbalance = std::abs(weights[0] - weights[1]);
+				size_t best = 0;
+				size_t stall = 0;
+
+				while (true)
+				{
+					int to = weights[0] <= weights[1] ? 0 : 1;
+					if (queues[to].empty())
+					{
+						to = 1 - to;
+					}
+					if (queues[to].empty())
+					{
+						break;
+					}
+
+					Entry entry = queues[to].top();
+					queues[to].pop();
+
+					I v = entry.second;
+					if (locked[v] || 2 != side[v] || entry.first != g.weights[v] - inside[1 - to][v])
+					{
+						continue;
+					}
+					if (weights[to] + g.weights[v] > limit)
+					{
+						continue;
+					}
+
+					locked[v] = 1;
+					assign(v, (char)to);
+
+					for (O p = g.starts[v]; p < g.starts[v + 1]; p++)
+					{
+						I u = g.adjacency[p];
+						if (1 - to == side[u])
+						{
+							assign(u, 2);
+						}
+					}
+
+					long long imbalance = std::abs(weights[0] - weights[1]);
+					if (weights[2] < bestSeparator || (weights[2] == bestSeparator && imbalance < bestImbalance))
+					{
+						bestSeparator = weights[2];
+						bestImbalance = imbalance;
+						best = history.size();
+						stall = 0;
+					}
+					else if (++stall > (size_t)StallCount)
+					{
+						break;
+					}
+				}
+
+				for (size_t k = history.size(); k > best; k--)
+				{
+					side[history[k - 1].first] = history[k - 1].second;
+				}
+
+				if (0 == best)
+				{
+					break;
+				}
+			}
+		}
+	};
+
+	using NestedDissection = BasicNestedDissection<int>;
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "SparseMatrix.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <vector>
@@ -17,8 +18,8 @@ namespace spandex
 			Pivots
 		};
 
-		template<class T>
-		static std::vector<T> NormTo(Type type, SparseMatrix<T>& a)
+		template<class T, class I, class O>
+		static std::vector<T> NormTo(Type type, SparseMatrix<T, I, O>& a)
 		{
 			if (Type::Pivots == type)
 			{
@@ -31,20 +32,43 @@ namespace spandex
 			}
 		}
 
-		template<class T>
-		static std::vector<T> NormPivotsTo(SparseMatrix<T>& a)
+		template<class T, class I, class O>
+		static void NormTo(Type type, SparseMatrix<T, I, O>& a, std::vector<T>& norm)
+		{
+			norm.resize(a.columnCount);
+
+			if (Type::Pivots == type)
+			{
+				NormPivotsTo(a, norm);
+			}
+			else
+			{
+				std::fill(norm.begin(), norm.end(), (T)1);
+			}
+		}
+
+		template<class T, class I, class O>
+		static std::vector<T> NormPivotsTo(SparseMatrix<T, I, O>& a)
+		{
+			std::vector<T> norm(a.columnCount);
+			NormPivotsTo(a, norm);
+
+			return std::move(norm);
+		}
+
+		template<class T, class I, class O>
+		static void NormPivotsTo(SparseMatrix<T, I, O>& a, std::vector<T>& norm)
 		{
 			T zero = (T)0;
 			T one = (T)1;
-			std::vector<T> norm(a.columnCount);
 
-			for (int j = 0; j < a.columnCount; j++)
+			for (I j = 0; j < a.columnCount; j++)
 			{
 				if (a.columns[j] == a.columns[j + 1])
 				{
 					throw std::runtime_error("should be positive defined");
 				}
-				int k = a.columns[j];
+				O k = a.columns[j];
 
 				if (a.values[k] == zero)
 				{
@@ -56,19 +80,17 @@ namespace spandex
 				a.values[k] = one;
 			}
 
-			for (int j = 0; j < a.columnCount; j++)
+			for (I j = 0; j < a.columnCount; j++)
 			{
 				double columnNorm = norm[j];
 
-				for (int i = a.columns[j] + 1; i < a.columns[j + 1]; i++)
+				for (O i = a.columns[j] + 1; i < a.columns[j + 1]; i++)
 				{
 					double rowNorm = norm[a.columnsRows[i]];
 
 					a.values[i] *= columnNorm * rowNorm;
 				}
 			}
-
-			return std::move(norm);
 		}
 	};
 }
\ No newline at end of file
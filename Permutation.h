@@ -1,34 +1,52 @@
 #pragma once
 
 #include "SparseMatrix.h"
-#include "EliminationGraph.h"
+#include "CuthillMcKee.h"
+#include "MinimumDegree.h"
+#include "NestedDissection.h"
 
-#include <limits>
-#include <vector>
+#include "misc/ThreadPool.h"
 
-#include "misc/SegmentTree.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <random>
+#include <vector>
 
 namespace spandex
 {
-	class Permutation
+	class PermutationBase
 	{
 	public:
 		enum Type
 		{
 			NoPermutation,
-			AMD
+			AMD,
+			NestedDissection,
+			COLAMD,
+			RCM,
+			Auto
 		};
+	};
+
+	template<class I>
+	class BasicPermutationSearch;
+
+	template<class I>
+	class BasicPermutation : public PermutationBase
+	{
+		friend class BasicPermutationSearch<I>;
 
 	private:
-		int size;
-		std::vector<int> primary;
-		std::vector<int> permuted;
+		I size;
+		std::vector<I> primary;
+		std::vector<I> permuted;
 
-		Permutation(int size) : size(size), primary(size, -1), permuted(size, -1)
+		BasicPermutation(I size) : size(size), primary(size, -1), permuted(size, -1)
 		{
 		}
 
-		void Insert(int prime, int perm)
+		void Insert(I prime, I perm)
 		{
 			assert(prime < size);
 			assert(perm < size);
@@ -39,98 +57,183 @@ namespace spandex
 		}
 
 	public:
-		Permutation() : size(0)
+		BasicPermutation() : size(0)
 		{}
 
-		int GetPrimary(int perm)
+		I GetPrimary(I perm)
 		{
 			assert(perm < size);
 
 			return primary[perm];
 		}
 
-		int GetPermuted(int prime)
+		I GetPermuted(I prime)
 		{
 			assert(prime < size);
 
 			return permuted[prime];
 		}
 
-		bool Equals(Permutation& that) const
+		bool Equals(BasicPermutation<I>& that) const
 		{
 			return primary == that.primary && permuted == that.permuted;
 		}
 
-		template<class T>
-		static Permutation Build(SparseMatrix<T>& a, Permutation::Type type)
+		template<class T, class O>
+		static BasicPermutation<I> Build(SparseMatrix<T, I, O>& a, Type type)
 		{
-			if (type == Permutation::Type::AMD)
-			{
-				return BuildAmd<T>(a);
-			}
-			else
+			return std::move(Build(a, type, 0, nullptr));
+		}
+
+		template<class T, class O>
+		static BasicPermutation<I> Build(SparseMatrix<T, I, O>& a, Type type, unsigned seed)
+		{
+			return std::move(Build(a, type, seed, nullptr));
+		}
+
+		template<class T, class O>
+		static BasicPermutation<I> Build(SparseMatrix<T, I, O>& a, Type type, misc::ThreadPool& pool)
+		{
+			return std::move(Build(a, type, 0, &pool));
+		}
+
+	private:
+		template<class T, class O>
+		static BasicPermutation<I> Build(SparseMatrix<T, I, O>& a, Type type, unsigned seed, misc::ThreadPool* pool)
+		{
+			assert(Type::Auto != type);
+
+			I n = a.columnCount;
+
+			if (Type::NoPermutation == type)
 			{
-				int n = a.columnCount;
-				Permutation pt(n);
+				BasicPermutation<I> pt(n);
 
-				for (int i = 0; i < n; i++)
+				for (I i = 0; i < n; i++)
 				{
 					pt.Insert(i, i);
 				}
 
 				return std::move(pt);
 			}
-		}
 
-	private:
-		template<class T>
-		static Permutation BuildAmd(SparseMatrix<T>& a)
-		{
-			using item = std::pair<int, double>;
-
-			int n = a.columnCount;
+			std::vector<I> order;
+			if (Type::COLAMD == type)
+			{
+				assert(Layout::DefaultLayout == a.layout);
 
-			Permutation pt(n);
-			EliminationGraph<T> eg(a);
+				order = BasicMinimumDegree<I, O>::OrderColumns(a.rowCount, a.columnCount, a.columns, a.columnsRows);
 
-			std::vector<item> inits(n);
-			for (int i = 0; i < n; i++)
-			{
-				inits[i] = item(i, eg.GetSize(i));
+				return std::move(FromOrder(order));
 			}
 
-			misc::SegmentTree<item> st(std::make_pair<int, double>(-1, std::numeric_limits<int>::max()),
-				[](const item& x, const item& y) { return x.second < y.second ? x : y; },
-				inits);
+			std::vector<O> starts;
+			std::vector<I> adjacency;
+			BuildGraph(a, starts, adjacency);
 
-			auto it = eg.GetIterator();
-			std::vector<int> vertices;
+			order = Order(n, starts, adjacency, type, seed, pool);
 
-			for (int i = 0; i < n; i++)
-			{
-				int min = st.GetTop().first;
+			return std::move(FromOrder(order));
+		}
 
-				pt.Insert(i, min);
+		template<class O>
+		static std::vector<I> Order(I n, const std::vector<O>& starts, const std::vector<I>& adjacency, Type type, unsigned seed,
+			misc::ThreadPool* pool)
+		{
+			if (0 != seed)
+			{
+				std::vector<I> labels(n);
+				std::iota(labels.begin(), labels.end(), 0);
+				std::shuffle(labels.begin(), labels.end(), std::mt19937(seed));
 
-				vertices.clear();
-				it.Setup(min);
-				while (it.HasNext())
+				std::vector<I> primaries(n);
+				for (I i = 0; i < n; i++)
 				{
-					vertices.push_back(it.Next().first);
+					primaries[labels[i]] = i;
 				}
 
-				eg.Eliminate(min);
+				std::vector<O> shuffledStarts(1, 0);
+				std::vector<I> shuffledAdjacency;
+				shuffledAdjacency.reserve(adjacency.size());
+				for (I i = 0; i < n; i++)
+				{
+					I v = primaries[i];
+					for (O p = starts[v]; p < starts[v + 1]; p++)
+					{
+						shuffledAdjacency.push_back(labels[adjacency[p]]);
+					}
+					shuffledStarts.push_back((O)shuffledAdjacency.size());
+				}
 
-				for (int j = 0; j < (int)vertices.size(); j++)
+				std::vector<I> order = Order(n, shuffledStarts, shuffledAdjacency, type, 0, pool);
+				for (I i = 0; i < n; i++)
 				{
-					int jj = vertices[j];
-					st.Set(jj, std::move(item(jj, eg.GetSize(jj))));
+					order[i] = primaries[order[i]];
 				}
 
-				st.Set(min, std::make_pair<int, double>(-1, std::numeric_limits<int>::max()));
+				return std::move(order);
+			}
+
+			if (Type::NestedDissection == type)
+			{
+				return nullptr == pool ?
+					BasicNestedDissection<I, O>::Order(n, starts, adjacency) :
+					BasicNestedDissection<I, O>::Order(n, starts, adjacency, *pool);
+			}
+			else if (Type::RCM == type)
+			{
+				return BasicCuthillMcKee<I, O>::Order(n, starts, adjacency);
+			}
+
+			return BasicMinimumDegree<I, O>::Order(n, starts, adjacency);
+		}
+
+		static BasicPermutation<I> FromOrder(const std::vector<I>& order)
+		{
+			I n = (I)order.size();
+			BasicPermutation<I> pt(n);
+			for (I i = 0; i < n; i++)
+			{
+				pt.Insert(i, order[i]);
 			}
 
 			return std::move(pt);
 		}
+
+		template<class T, class O>
+		static void BuildGraph(SparseMatrix<T, I, O>& a, std::vector<O>& starts, std::vector<I>& adjacency)
+		{
+			assert(Layout::DefaultLayout == a.layout);
+
+			if (!a.HasRows())
+			{
+				a.BuildRows();
+			}
+
+			I n = a.columnCount;
+			starts.assign(1, 0);
+			adjacency.clear();
+
+			std::vector<I> mark(n, -1);
+			for (I j = 0; j < n; j++)
+			{
+				mark[j] = j;
+				for (O i = a.columns[j]; i < a.columns[j + 1]; i++)
+				{
+					I ii = a.columnsRows[i];
+					for (O k = a.rows[ii]; k < a.rows[ii + 1]; k++)
+					{
+						I r = a.rowsColumns[k];
+						if (mark[r] != j)
+						{
+							mark[r] = j;
+							adjacency.push_back(r);
+						}
+					}
+				}
+				starts.push_back((O)adjacency.size());
+			}
+		}
 	};
+	using Permutation = BasicPermutation<int>;
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "SparseMatrix.h"
+#include "Permutation.h"
+#include "EliminationTree.h"
+
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+namespace spandex
+{
+	template<class I>
+	class BasicPermutationSearch
+	{
+	public:
+		struct Candidate
+		{
+			PermutationBase::Type type;
+			unsigned seed;
+			bool evaluated;
+			long long nnz;
+			double flops;
+			double seconds;
+		};
+
+		std::vector<Candidate> candidates;
+		I best;
+
+		BasicPermutationSearch() : best(-1)
+		{
+		}
+
+		const Candidate& GetBest() const
+		{
+			assert(0 <= best);
+
+			return candidates[best];
+		}
+
+		template<class T, class O>
+		static BasicPermutationSearch<I> Search(SparseMatrix<T, I, O>& a, int seeds, double budget, BasicPermutation<I>& perm)
+		{
+			return std::move(Search(a, seeds, budget, perm, nullptr));
+		}
+
+		template<class T, class O>
+		static BasicPermutationSearch<I> Search(SparseMatrix<T, I, O>& a, int seeds, double budget, BasicPermutation<I>& perm,
+			misc::ThreadPool& pool)
+		{
+			return std::move(Search(a, seeds, budget, perm, &pool));
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		template<class T, class O>
+		static BasicPermutationSearch<I> Search(SparseMatrix<T, I, O>& a, int seeds, double budget, BasicPermutation<I>& perm,
+			misc::ThreadPool* pool)
+		{
+			assert(Layout::DefaultLayout == a.layout);
+
+			if (!a.HasRows())
+			{
+				a.BuildRows();
+			}
+
+			BasicPermutationSearch<I> search;
+			for (auto type : { PermutationBase::Type::NoPermutation, PermutationBase::Type::COLAMD, PermutationBase::Type::AMD })
+			{
+				search.candidates.push_back({ type, 0, false, 0, 0.0, 0.0 });
+			}
+			for (int s = 1; s <= seeds; s++)
+			{
+				search.candidates.push_back({ PermutationBase::Type::AMD, (unsigned)s, false, 0, 0.0, 0.0 });
+			}
+			for (auto type : { PermutationBase::Type::RCM, PermutationBase::Type::NestedDissection })
+			{
+				search.candidates.push_back({ type, 0, false, 0, 0.0, 0.0 });
+			}
+
+			I n = a.columnCount;
+			size_t count = search.candidates.size();
+			std::vector<BasicPermutation<I>> perms(count);
+
+			std::once_flag built;
+			std::vector<O> starts;
+			std::vector<I> adjacency;
+			bool dense = false;
+
+			auto start = Clock::now();
+			std::atomic<size_t> next(0);
+			auto run = [&](int /*thread*/)
+			{
+				for (size_t c = next++; c < count; c = next++)
+				{
+					if (c > 1 && GetSeconds(start) >= budget)
+					{
+						break;
+					}
+
+					auto& candidate = search.candidates[c];
+					auto begin = Clock::now();
+
+					if (PermutationBase::Type::NoPermutation == candidate.type || PermutationBase::Type::COLAMD == candidate.type)
+					{
+						perms[c] = BasicPermutation<I>::Build(a, candidate.type);
+					}
+					else
+					{
+						std::call_once(built, [&]()
+							{
+								BasicPermutation<I>::BuildGraph(a, starts, adjacency);
+
+								I limit = std::max((I)16, (I)(10 * std::sqrt((double)n)));
+								for (I v = 0; v < n && !dense; v++)
+								{
+									dense = (I)(starts[v + 1] - starts[v]) > limit;
+								}
+							});
+						if (dense && PermutationBase::Type::NestedDissection == candidate.type)
+						{
+							continue;
+						}
+
+						perms[c] = BasicPermutation<I>::FromOrder(
+							BasicPermutation<I>::Order(n, starts, adjacency, candidate.type, candidate.seed, nullptr));
+					}
+
+					auto tree = BasicEliminationTree<I>::BuildSqr(a, perms[c]);
+					candidate.nnz = tree.GetNnz();
+					for (I j = 0; j < n; j++)
+					{
+						candidate.flops += (double)tree.columnCounts[j] * tree.columnCounts[j];
+					}
+					candidate.seconds = GetSeconds(begin);
+					candidate.evaluated = true;
+				}
+			};
+
+			if (nullptr == pool)
+			{
+				run(0);
+			}
+			else
+			{
+				pool->Run(run);
+			}
+
+			for (size_t c = 0; c < count; c++)
+			{
+				auto& candidate = search.candidates[c];
+				if (candidate.evaluated && (0 > search.best || candidate.flops < search.GetBest().flops ||
+					(candidate.flops == search.GetBest().flops && candidate.nnz < search.GetBest().nnz)))
+				{
+					search.best = (I)c;
+				}
+			}
+
+			perm = std::move(perms[search.best]);
+
+			return std::move(search);
+		}
+
+		static double GetSeconds(Clock::time_point since)
+		{
+			return std::chrono::duration<double>(Clock::now() - since).count();
+		}
+	};
+	using PermutationSearch = BasicPermutationSearch<int>;
+}
\ No newline at end of file
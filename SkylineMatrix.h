@@ -0,0 +1,408 @@
+#pragma once
+
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <vector>
+
+namespace spandex
+{
+	template<class T, class I = int, class O = I>
+	class SkylineMatrix
+	{
+	public:
+		std::vector<I> firsts;
+		std::vector<O> rows;
+		std::vector<T> values;
+
+		I size;
+
+	private:
+		std::vector<T> inverse;
+		std::vector<I> clamped;
+
+	public:
+		SkylineMatrix() : size(0)
+		{
+		}
+
+		static long long GetProfile(const SparseMatrix<T, I, O>& ld)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+
+			std::vector<I> firsts = GetFirsts(ld);
+
+			long long profile = 0;
+			for (I i = 0; i < ld.rowCount; i++)
+			{
+				profile += i - firsts[i] + 1;
+			}
+
+			return profile;
+		}
+
+		static SkylineMatrix<T, I, O> FromPattern(const SparseMatrix<T, I, O>& ld)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+
+			I n = ld.rowCount;
+
+			SkylineMatrix<T, I, O> sm;
+			sm.size = n;
+			sm.firsts = GetFirsts(ld);
+			sm.rows.resize(1 + n, 0);
+			for (I i = 0; i < n; i++)
+			{
+				sm.rows[i + 1] = sm.rows[i] + (i - sm.firsts[i] + 1);
+			}
+			sm.values.resize(sm.rows[n]);
+
+			return std::move(sm);
+		}
+
+		void CholTo(SparseMatrix<T, I, O>& sym, T tolerance)
+		{
+			assert(Layout::LowerSymmetric == sym.layout);
+			assert(size == sym.columnCount);
+
+			const T zero = (T)0;
+
+			if (!sym.HasRows())
+			{
+				std::fill(values.begin(), values.end(), T());
+				for (I j = 0; j < size; j++)
+				{
+					for (O k = sym.columns[j]; k < sym.columns[j + 1]; k++)
+					{
+						I i = sym.columnsRows[k];
+						values[rows[i] + (j - firsts[i])] = sym.values[k];
+					}
+				}
+			}
+
+			inverse.resize(size);
+			clamped.clear();
+
+			for (I i = 0; i < size; i++)
+			{
+				I fi = firsts[i];
+				T* li = &values[rows[i]];
+
+				if (sym.HasRows())
+				{
+					std::fill(li, li + (i - fi + 1), T());
+					for (O k = sym.rows[i]; k < sym.rows[i + 1]; k++)
+					{
+						li[sym.rowsColumns[k] - fi] = sym.values[sym.positions[k]];
+					}
+				}
+
+				auto from = std::lower_bound(clamped.begin(), clamped.end(), fi);
+				for (I j = fi; j < i; j++)
+				{
+					I fj = firsts[j];
+
+					li[j - fi] -= Sum(li, fi, &values[rows[j]], fj, std::max(fi, fj), j, from);
+				}
+
+				T d = li[i - fi];
+				I k = fi;
+				for (auto c = from;; ++c)
+				{
+					I end = clamped.end() == c ? i : *c;
+					for (; k < end; k++)
+					{
+						T g = li[k - fi];
+						T l = g * inverse[k];
+
+						d -= l * g;
+						li[k - fi] = l;
+					}
+
+					if (clamped.end() == c)
+					{
+						break;
+					}
+
+					T l = li[k - fi] * inverse[k];
+					d -= l * values[rows[k + 1] - 1] * l;
+					li[k - fi] = l;
+					k++;
+				}
+				li[i - fi] = d;
+
+				if (d <= zero)
+				{
+					inverse[i] = (T)1 / tolerance;
+					clamped.push_back(i);
+				}
+				else
+				{
+					inverse[i] = (T)1 / d;
+				}
+			}
+		}
+
+		void CopyTo(SparseMatrix<T, I, O>& ld) const
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+			assert(size == ld.columnCount);
+
+			for (I j = 0; j < size; j++)
+			{
+				for (O k = ld.columns[j]; k < ld.columns[j + 1]; k++)
+				{
+					I i = ld.columnsRows[k];
+					ld.values[k] = values[rows[i] + (j - firsts[i])];
+				}
+			}
+		}
+
+		void Update(std::span<T> p, std::span<T> c)
+		{
+			assert(size == (I)p.size());
+			assert(size == (I)c.size());
+
+			const T zero = (T)0;
+			T a = (T)1;
+
+			I start = GetStart(p);
+			for (I i = start; i < size; i++)
+			{
+				I fi = std::max(firsts[i], start);
+				T* li = &values[rows[i] + (fi - firsts[i])];
+
+				T x = p[i];
+				for (I k = fi; k < i; k++)
+				{
+					x -= p[k] * li[k - fi];
+					li[k - fi] += c[k] * x;
+				}
+				p[i] = x;
+
+				c[i] = zero;
+				if (zero != x)
+				{
+					T& d = values[rows[i + 1] - 1];
+					T b = a + x * x / d;
+					c[i] = x / (d * b);
+					d = d * b / a;
+					a = b;
+				}
+			}
+		}
+
+		void Downdate(std::span<T> p, T tolerance, std::span<T> c)
+		{
+			assert(size == (I)p.size());
+			assert(size == (I)c.size());
+
+			SolveLowerTo(p, p);
+
+			T sum = (T)0;
+			for (I i = 0; i < size; i++)
+			{
+				sum += p[i] / values[rows[i + 1] - 1] * p[i];
+			}
+
+			T a = (T)1 - sum;
+			if (a <= tolerance)
+			{
+				a = tolerance;
+			}
+
+			I start = GetStart(p);
+			for (I j = size - 1; j >= start; j--)
+			{
+				T& d = values[rows[j + 1] - 1];
+				T b = a + p[j] * p[j] / d;
+				c[j] = -p[j] / (d * a);
+				d = d * a / b;
+				a = b;
+			}
+
+			for (I i = start; i < size; i++)
+			{
+				I fi = std::max(firsts[i], start);
+				T* li = &values[rows[i] + (fi - firsts[i])];
+
+				T v = p[i];
+				for (I k = i - 1; k >= fi; k--)
+				{
+					T t = v;
+					v += p[k] * li[k - fi];
+					li[k - fi] += c[k] * t;
+				}
+			}
+		}
+
+		void SolveLowerTo(std::span<const T> b, std::span<T> y) const
+		{
+			assert(size == (I)b.size());
+			assert(size == (I)y.size());
+
+			for (I i = 0; i < size; i++)
+			{
+				I fi = firsts[i];
+				y[i] = b[i] - Dot(&values[rows[i]], y.data() + fi, i - fi);
+			}
+		}
+
+		void SolveUpperTo(std::span<T> x) const
+		{
+			assert(size == (I)x.size());
+
+			for (I i = 0; i < size; i++)
+			{
+				x[i] /= values[rows[i + 1] - 1];
+			}
+
+			for (I i = size - 1; i >= 0; i--)
+			{
+				I fi = firsts[i];
+				const T* li = &values[rows[i]];
+				T* target = x.data() + fi;
+				T xi = x[i];
+
+				for (I k = 0; k < i - fi; k++)
+				{
+					target[k] -= li[k] * xi;
+				}
+			}
+		}
+
+		void SolveLowerTo(std::span<const T> b, std::span<T> y, int k) const
+		{
+			assert((size_t)size * k == b.size());
+			assert((size_t)size * k == y.size());
+
+			for (I i = 0; i < size; i++)
+			{
+				I fi = firsts[i];
+				const T* li = &values[rows[i]];
+				T* target = y.data() + (size_t)i * k;
+
+				std::copy(b.data() + (size_t)i * k, b.data() + (size_t)(i + 1) * k, target);
+				for (I j = fi; j < i; j++)
+				{
+					T value = li[j - fi];
+					const T* source = y.data() + (size_t)j * k;
+
+					for (int t = 0; t < k; t++)
+					{
+						target[t] -= value * source[t];
+					}
+				}
+			}
+		}
+
+		void SolveUpperTo(std::span<T> x, int k) const
+		{
+			assert((size_t)size * k == x.size());
+
+			for (I i = 0; i < size; i++)
+			{
+				T d = values[rows[i + 1] - 1];
+				T* target = x.data() + (size_t)i * k;
+
+				for (int t = 0; t < k; t++)
+				{
+					target[t] /= d;
+				}
+			}
+
+			for (I i = size - 1; i >= 0; i--)
+			{
+				I fi = firsts[i];
+				const T* li = &values[rows[i]];
+				const T* source = x.data() + (size_t)i * k;
+
+				for (I j = fi; j < i; j++)
+				{
+					T value = li[j - fi];
+					T* target = x.data() + (size_t)j * k;
+
+					for (int t = 0; t < k; t++)
+					{
+						target[t] -= value * source[t];
+					}
+				}
+			}
+		}
+
+	private:
+		T Sum(const T* li, I fi, const T* lj, I fj, I k, I j, typename std::vector<I>::const_iterator c) const
+		{
+			T sum = T();
+			for (; clamped.end() != c && *c < j; ++c)
+			{
+				if (*c < k)
+				{
+					continue;
+				}
+
+				sum += Dot(li + (k - fi), lj + (k - fj), *c - k);
+				sum += li[*c - fi] * inverse[*c] * values[rows[*c + 1] - 1] * lj[*c - fj];
+				k = *c + 1;
+			}
+
+			return sum + Dot(li + (k - fi), lj + (k - fj), j - k);
+		}
+
+		I GetStart(std::span<const T> p) const
+		{
+			const T zero = (T)0;
+
+			I start = 0;
+			while (start < size && zero == p[start])
+			{
+				start++;
+			}
+
+			return start;
+		}
+
+		static std::vector<I> GetFirsts(const SparseMatrix<T, I, O>& ld)
+		{
+			I n = ld.rowCount;
+			std::vector<I> firsts(n);
+			for (I i = 0; i < n; i++)
+			{
+				firsts[i] = i;
+			}
+
+			for (I j = 0; j < n; j++)
+			{
+				for (O k = ld.columns[j]; k < ld.columns[j + 1]; k++)
+				{
+					I i = ld.columnsRows[k];
+					firsts[i] = std::min(firsts[i], j);
+				}
+			}
+
+			return std::move(firsts);
+		}
+
+		static T Dot(const T* a, const T* b, I count)
+		{
+			T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+
+			I k = 0;
+			for (; k + 4 <= count; k += 4)
+			{
+				s0 += a[k] * b[k];
+				s1 += a[k + 1] * b[k + 1];
+				s2 += a[k + 2] * b[k + 2];
+				s3 += a[k + 3] * b[k + 3];
+			}
+			for (; k < count; k++)
+			{
+				s0 += a[k] * b[k];
+			}
+
+			return (s0 + s1) + (s2 + s3);
+		}
+	};
+}
\ No newline at end of file
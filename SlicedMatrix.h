@@ -0,0 +1,180 @@
+#pragma once
+
+#include "SparseMatrix.h"
+
+#include "misc/Simd.h"
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace spandex
+{
+	template<class T, class I = int, class O = I>
+	class SlicedMatrix
+	{
+	public:
+		std::vector<O> slices;
+		std::vector<I> slicesColumns;
+		std::vector<T> values;
+
+		std::vector<I> slicesRows;
+
+		O nnz;
+		I rowCount;
+		I columnCount;
+		I chunk;
+		I sigma;
+
+		SlicedMatrix() : nnz(0), rowCount(0), columnCount(0), chunk(1), sigma(1)
+		{
+		}
+
+		static SlicedMatrix<T, I, O> FromMatrix(SparseMatrix<T, I, O>& a, I chunk = 0, I sigma = 0)
+		{
+			if (!a.HasRows())
+			{
+				a.BuildRows();
+			}
+
+			return std::move(FromMatrix(std::as_const(a), chunk, sigma));
+		}
+
+		static SlicedMatrix<T, I, O> FromMatrix(const SparseMatrix<T, I, O>& a, I chunk = 0, I sigma = 0)
+		{
+			if (!a.HasRows())
+			{
+				throw std::logic_error("row index is not built");
+			}
+
+			if (chunk <= 0)
+			{
+				chunk = (I)misc::Simd::GetLanes((int)sizeof(T));
+			}
+			if (sigma <= 0)
+			{
+				sigma = chunk * 32;
+			}
+
+			SlicedMatrix<T, I, O> sm;
+			sm.nnz = a.nnz;
+			sm.rowCount = a.rowCount;
+			sm.columnCount = a.columnCount;
+			sm.chunk = chunk;
+			sm.sigma = sigma;
+
+			I count = (a.rowCount + chunk - 1) / chunk;
+
+			sm.slicesRows.resize((size_t)count * chunk);
+			std::iota(sm.slicesRows.begin(), sm.slicesRows.end(), 0);
+
+			auto length = [&](I i)
+			{
+				return i < a.rowCount ? a.rows[i + 1] - a.rows[i] : (O)0;
+			};
+
+			for (I i = 0; i < a.rowCount; i += sigma)
+			{
+				auto begin = sm.slicesRows.begin() + i;
+				auto end = sm.slicesRows.begin() + std::min(i + sigma, a.rowCount);
+
+				std::stable_sort(begin, end, [&](I x, I y) { return length(x) > length(y); });
+			}
+
+			sm.slices.resize(1 + count, 0);
+			for (I s = 0; s < count; s++)
+			{
+				O width = 0;
+				for (I r = 0; r < chunk; r++)
+				{
+					width = std::max(width, length(sm.slicesRows[s * chunk + r]));
+				}
+				sm.slices[s + 1] = sm.slices[s] + width * chunk;
+			}
+
+			sm.slicesColumns.resize(sm.slices[count]);
+			sm.values.resize(sm.slices[count]);
+
+			for (I s = 0; s < count; s++)
+			{
+				for (I r = 0; r < chunk; r++)
+				{
+					I i = sm.slicesRows[s * chunk + r];
+					O k = sm.slices[s] + r;
+					I last = 0;
+
+					if (i < a.rowCount)
+					{
+						for (O p = a.rows[i]; p < a.rows[i + 1]; p++, k += chunk)
+						{
+							last = a.rowsColumns[p];
+							sm.slicesColumns[k] = last;
+							sm.values[k] = a.values[a.positions[p]];
+						}
+					}
+
+					for (; k < sm.slices[s + 1]; k += chunk)
+					{
+						sm.slicesColumns[k] = last;
+						sm.values[k] = (T)0;
+					}
+				}
+			}
+
+			return std::move(sm);
+		}
+
+		I GetSliceCount() const
+		{
+			return (I)slices.size() - 1;
+		}
+
+		O GetStored() const
+		{
+			return slices.back();
+		}
+
+		double GetPadding() const
+		{
+			return 0 == nnz ? 0.0 : (double)(GetStored() - nnz) / nnz;
+		}
+
+		std::vector<T> Mul(const std::vector<T>& x) const
+		{
+			std::vector<T> y(rowCount);
+			MulTo(x, y);
+			return std::move(y);
+		}
+
+		void MulTo(std::span<const T> x, std::span<T> y) const
+		{
+			assert(columnCount == (I)x.size());
+			assert(rowCount == (I)y.size());
+
+			MulSlices(x, y, 0, GetSliceCount());
+		}
+
+		void MulTo(std::span<const T> x, std::span<T> y, misc::ThreadPool& pool) const
+		{
+			assert(columnCount == (I)x.size());
+			assert(rowCount == (I)y.size());
+
+			pool.For(0, (int)GetSliceCount(), [&](int /*thread*/, int from, int to)
+				{
+					MulSlices(x, y, (I)from, (I)to);
+				});
+		}
+
+	private:
+		void MulSlices(std::span<const T> x, std::span<T> y, I from, I to) const
+		{
+			misc::Simd::SlicedTo(slices.data(), slicesColumns.data(), values.data(), x.data(), y.data(), slicesRows.data(), rowCount, chunk,
+				from, to);
+		}
+	};
+}
\ No newline at end of file
@@ -2,13 +2,18 @@
 
 #include "misc/CommonGraph.h"
 #include "misc/IntList.h"
+#include "misc/Simd.h"
+#include "misc/ThreadPool.h"
 #include "SparseArray.h"
 
 #include <cassert>
 #include <algorithm>
 #include <stdexcept>
 #include <functional>
+#include <limits>
 #include <numeric>
+#include <span>
+#include <utility>
 #include <vector>
 
 
@@ -19,34 +24,35 @@ namespace spandex
 		DefaultLayout, LowerTriangle, UpperTriangle, LowerSymmetric, UpperSymmetric
 	};
 
-	template<class T>
+	template<class T, class I = int, class O = I>
 	class SparseMatrix
 	{
 	public:
-		std::vector<int> columns;
-		std::vector<int> columnsRows;
+		std::vector<O> columns;
+		std::vector<I> columnsRows;
 		std::vector<T> values;
 
-		std::vector<int> rows;
-		std::vector<int> rowsColumns;
-		std::vector<int> positions;
+		std::vector<O> rows;
+		std::vector<I> rowsColumns;
+		std::vector<O> positions;
+		std::vector<T> rowsValues;
 
 
 		Layout layout;
-		int nnz;
-		int rowCount;
-		int columnCount;
+		O nnz;
+		I rowCount;
+		I columnCount;
 
 	private:
 
-		misc::IntList list;
+		misc::BasicIntList<I> list;
 
-		SparseMatrix(int rowCount, int columnCount, int capacity) : SparseMatrix()
+		SparseMatrix(I rowCount, I columnCount, O capacity) : SparseMatrix()
 		{
 			Resize(rowCount, columnCount, capacity);
 		}
 
-		void Resize(int rowCount, int columnCount, int capacity)
+		void Resize(I rowCount, I columnCount, O capacity)
 		{
 			list.Resize(std::max(rowCount, columnCount));
 			layout = Layout::DefaultLayout;
@@ -62,7 +68,7 @@ namespace spandex
 			rows.resize(1 + rowCount);
 			rowsColumns.resize(capacity);
 			positions.resize(capacity);
-
+			rowsValues.clear();
 		}
 
 	public:
@@ -70,17 +76,17 @@ namespace spandex
 		{
 		}
 
-		SparseMatrix(const SparseMatrix<T>& copy) :SparseMatrix()
+		SparseMatrix(const SparseMatrix<T, I, O>& copy) :SparseMatrix()
 		{
 			operator=(copy);
 		}
 
-		SparseMatrix(SparseMatrix<T>&& move) noexcept : SparseMatrix()
+		SparseMatrix(SparseMatrix<T, I, O>&& move) noexcept : SparseMatrix()
 		{
 			operator=(move);
 		}
 
-		SparseMatrix<T>& operator=(const SparseMatrix<T>& copy)
+		SparseMatrix<T, I, O>& operator=(const SparseMatrix<T, I, O>& copy)
 		{
 			Resize(copy.rowCount, copy.columnCount, copy.nnz);
 
@@ -95,11 +101,12 @@ namespace spandex
 			rows.assign(std::begin(copy.rows), std::end(copy.rows));
 			rowsColumns.assign(std::begin(copy.rowsColumns), std::end(copy.rowsColumns));
 			positions.assign(std::begin(copy.positions), std::end(copy.positions));
+			rowsValues.assign(std::begin(copy.rowsValues), std::end(copy.rowsValues));
 
 			return *this;
 		}
 
-		SparseMatrix<T>& operator=(SparseMatrix<T>&& move)
+		SparseMatrix<T, I, O>& operator=(SparseMatrix<T, I, O>&& move)
 		{
 			Resize(move.rowCount, move.columnCount, move.nnz);
 
@@ -113,138 +120,104 @@ namespace spandex
 			rows = std::move(move.rows);
 			rowsColumns = std::move(move.rowsColumns);
 			positions = std::move(move.positions);
+			rowsValues = std::move(move.rowsValues);
 
 			return *this;
 		}
 
-		static SparseMatrix<T> Empty(int rowCount, int columnCount, int capacity)
+		static SparseMatrix<T, I, O> Empty(I rowCount, I columnCount, O capacity)
 		{
-			return SparseMatrix<T>(rowCount, columnCount, capacity);
+			return SparseMatrix<T, I, O>(rowCount, columnCount, capacity);
 		}
 
-		static SparseMatrix<T> FromCSR(int rowCount, int columnCount,
-			const std::vector<int>& rows, const std::vector<int>& columns, const std::vector<T>& values)
+		template<class I2, class O2>
+		static SparseMatrix<T, I, O> FromMatrix(const SparseMatrix<T, I2, O2>& that)
 		{
-			assert(rowCount == ((int)rows.size() - 1));
-			assert(values.size() == columns.size());
-			assert((int)values.size() == rows.back());
+			assert((unsigned long long)that.nnz <= (unsigned long long)std::numeric_limits<O>::max());
 
-			auto sparse = SparseMatrix<T>::Empty(rowCount, columnCount, (int)values.size());
-			sparse.nnz = (int)values.size();
-			sparse.rows = rows;
+			auto sparse = SparseMatrix<T, I, O>::Empty((I)that.rowCount, (I)that.columnCount, (O)that.nnz);
+			sparse.layout = that.layout;
+			sparse.nnz = (O)that.nnz;
 
-			for (int i = 0; i < rowCount; i++)
-			{
-				for (int j = rows[i]; j < rows[i + 1]; j++)
-				{
-					sparse.columns[columns[j] + 1] += 1;
-				}
-			}
+			sparse.columns.assign(that.columns.begin(), that.columns.end());
+			sparse.columnsRows.assign(that.columnsRows.begin(), that.columnsRows.end());
+			sparse.values.assign(that.values.begin(), that.values.end());
 
-			for (int j = 1; j < 1 + columnCount; j++)
-			{
-				sparse.columns[j] += sparse.columns[j - 1];
-			}
-
-			std::vector<int> tcolumns(sparse.columns);
-			std::vector<int> trows(sparse.rows);
-			for (int i = 0; i < rowCount; i++)
-			{
-				for (int j = rows[i]; j < rows[i + 1]; j++)
-				{
-					int c = tcolumns[columns[j]];
-					sparse.columnsRows[c] = i;
-					sparse.values[c] = values[j];
-
-					sparse.rowsColumns[trows[i]] = columns[j];
-					sparse.positions[trows[i]] = c;
-
-					tcolumns[columns[j]] += 1;
-					trows[i] += 1;
-				}
-			}
-
-			sparse.Sort();
+			sparse.rows.assign(that.rows.begin(), that.rows.end());
+			sparse.rowsColumns.assign(that.rowsColumns.begin(), that.rowsColumns.end());
+			sparse.positions.assign(that.positions.begin(), that.positions.end());
+			sparse.rowsValues.assign(that.rowsValues.begin(), that.rowsValues.end());
 
 			return std::move(sparse);
 		}
 
-		static SparseMatrix<T> FromGraph(int rowCount, int columnCount, misc::CommonGraph<T>& graph)
+		static SparseMatrix<T, I, O> FromCSR(I rowCount, I columnCount,
+			const std::vector<O>& rows, const std::vector<I>& columns, const std::vector<T>& values)
 		{
-			auto sparse = SparseMatrix<T>::Empty(rowCount, columnCount, graph.size);
-			sparse.nnz = graph.size;
-
-			sparse.rows[0] = 0;
-			std::vector<T> values(sparse.nnz);
-
-			auto it = graph.GetIterator();
-			for (int i = 0, k = 0; i < rowCount; i++)
-			{
-				it.Setup(i);
-				while (it.HasNext())
-				{
-					auto item = it.Next();
+			return std::move(FromCSR(rowCount, columnCount, rows, columns, values, nullptr));
+		}
 
-					sparse.rowsColumns[k] = item.first;
-					sparse.columns[item.first] += 1;
-					values[k] = item.second;
+		static SparseMatrix<T, I, O> FromCSR(I rowCount, I columnCount,
+			const std::vector<O>& rows, const std::vector<I>& columns, const std::vector<T>& values, misc::ThreadPool& pool)
+		{
+			return std::move(FromCSR(rowCount, columnCount, rows, columns, values, &pool));
+		}
 
-					k += 1;
-				}
-				sparse.rows[i + 1] = k;
-			}
+		static SparseMatrix<T, I, O> FromGraph(I rowCount, I columnCount, misc::CommonGraph<T, I>& graph)
+		{
+			return std::move(FromGraph(rowCount, columnCount, graph, nullptr));
+		}
 
-			for (int i = 0, n = 0; i <= columnCount; i++)
-			{
-				int t = n;
-				n += sparse.columns[i];
-				sparse.columns[i] = t;
-			}
+		static SparseMatrix<T, I, O> FromGraph(I rowCount, I columnCount, misc::CommonGraph<T, I>& graph, misc::ThreadPool& pool)
+		{
+			return std::move(FromGraph(rowCount, columnCount, graph, &pool));
+		}
 
-			std::vector<int> colIndex = sparse.columns;
-			for (int i = 0, n = 0; i < rowCount; i++)
-			{
-				for (int j = sparse.rows[i]; j < sparse.rows[i + 1]; j++)
-				{
-					int col = sparse.rowsColumns[j];
-					sparse.positions[j] = colIndex[col];
-					sparse.values[colIndex[col]] = values[j];
-					sparse.columnsRows[colIndex[col]] = i;
-					colIndex[col] += 1;
-				}
-			}
+	public:
+		void Sort()
+		{
+			Sort(nullptr);
+		}
 
-			sparse.Sort();
+		void Sort(misc::ThreadPool& pool)
+		{
+			Sort(&pool);
+		}
 
-			return std::move(sparse);
+		bool HasRows() const
+		{
+			return (I)rows.size() == 1 + rowCount;
 		}
 
-	public:
-		void Sort()
+		void BuildRows()
 		{
-			std::vector<int> oldIndices(nnz);
-			std::iota(std::begin(oldIndices), std::end(oldIndices), 0);
-			auto newIndices = oldIndices;
+			BuildRows(nullptr);
+		}
 
-			for (int j = 0; j < columnCount; j++)
-			{
-				KeyValueSort(columnsRows, newIndices, columns[j], columns[j + 1]);
-			}
+		void BuildRows(misc::ThreadPool& pool)
+		{
+			BuildRows(&pool);
+		}
 
-			Reindex(values, oldIndices, newIndices);
+		void DropRows()
+		{
+			std::vector<O>().swap(rows);
+			std::vector<I>().swap(rowsColumns);
+			std::vector<O>().swap(positions);
+			std::vector<T>().swap(rowsValues);
+		}
 
-			for (int j = 0; j < rowCount; j++)
-			{
-				KeyValueSort(rowsColumns, positions, rows[j], rows[j + 1]);
-			}
+		void SyncRows()
+		{
+			SyncRows(nullptr);
+		}
 
-			for (int i = 0; i < nnz; i++)
-			{
-				positions[i] = newIndices[positions[i]];
-			}
+		void SyncRows(misc::ThreadPool& pool)
+		{
+			SyncRows(&pool);
 		}
 
-		bool Equals(const SparseMatrix<T>& that) const
+		bool Equals(const SparseMatrix<T, I, O>& that) const
 		{
 			if (nnz != that.nnz)
 			{
@@ -278,7 +251,7 @@ namespace spandex
 			return true;
 		}
 
-		bool Equals(const SparseMatrix<T>& that, std::function<bool(const T&, const T&)> compareFunc) const
+		bool Equals(const SparseMatrix<T, I, O>& that, std::function<bool(const T&, const T&)> compareFunc) const
 		{
 			if (nnz != that.nnz)
 			{
@@ -305,7 +278,7 @@ namespace spandex
 				return false;
 			}
 
-			for (int i = 0; i < nnz; i++)
+			for (O i = 0; i < nnz; i++)
 			{
 				if (!compareFunc(values[i], that.values[i]))
 				{
@@ -316,9 +289,14 @@ namespace spandex
 			return true;
 		}
 
-		SparseMatrix<T> Transpose()
+		SparseMatrix<T, I, O> Transpose()
 		{
-			auto that = SparseMatrix<T>::Empty(columnCount, rowCount, nnz);
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
+			auto that = SparseMatrix<T, I, O>::Empty(columnCount, rowCount, nnz);
 
 			that.nnz = nnz;
 			that.columns.assign(std::begin(rows), std::end(rows));
@@ -326,24 +304,26 @@ namespace spandex
 			that.rows.assign(std::begin(columns), std::end(columns));
 			that.rowsColumns.assign(std::begin(columnsRows), std::end(columnsRows));
 
-			for (int k = 0, j = 0; j < columnCount; j++)
+			O k = 0;
+			for (I j = 0; j < columnCount; j++)
 			{
-				for (int i = columns[j]; i < columns[j + 1]; i++, k++)
+				for (O i = columns[j]; i < columns[j + 1]; i++, k++)
 				{
 					that.positions[positions[i]] = k;
 					that.values[k] = values[positions[i]];
 				}
 			}
+			that.SyncRows();
 
 			return std::move(that);
 		}
 
-		bool Contains(int row, int column) const
+		bool Contains(I row, I column) const
 		{
 			assert(column >= 0 && column < columnCount);
 			assert(row >= 0 && row < rowCount);
 
-			for (int j = columns[column]; j < columns[column + 1]; j++)
+			for (O j = columns[column]; j < columns[column + 1]; j++)
 			{
 				if (row == columnsRows[j])
 				{
@@ -360,7 +340,7 @@ namespace spandex
 
 			std::vector<T> vals(rowCount);
 
-			for (int i = 0; i < rowCount; i++)
+			for (I i = 0; i < rowCount; i++)
 			{
 				vals[i] = GetColumnwise(i, i);
 			}
@@ -368,13 +348,28 @@ namespace spandex
 			return std::move(vals);
 		}
 
-		SparseArray<T> GetRow(int row) const
+		SparseArray<T> GetRow(I row)
+		{
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
+			return std::move(std::as_const(*this).GetRow(row));
+		}
+
+		SparseArray<T> GetRow(I row) const
 		{
 			assert(row >= 0 && row < rowCount);
 
+			if (!HasRows())
+			{
+				throw std::logic_error("row index is not built");
+			}
+
 			SparseArray<T> vals(columnCount);
 
-			for (int i = rows[row]; i < rows[row + 1]; i++)
+			for (O i = rows[row]; i < rows[row + 1]; i++)
 			{
 				vals.Insert(rowsColumns[i], values[positions[i]]);
 			}
@@ -382,13 +377,13 @@ namespace spandex
 			return std::move(vals);
 		}
 
-		SparseArray<T> GetColumn(int column) const
+		SparseArray<T> GetColumn(I column) const
 		{
 			assert(column >= 0 && column < columnCount);
 
 			SparseArray<T> vals(rowCount);
 
-			for (int j = columns[column]; j < columns[column + 1]; j++)
+			for (O j = columns[column]; j < columns[column + 1]; j++)
 			{
 				vals.Insert(columnsRows[j], values[j]);
 			}
@@ -396,12 +391,27 @@ namespace spandex
 			return std::move(vals);
 		}
 
-		T GetRowwise(int row, int column) const
+		T GetRowwise(I row, I column)
+		{
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
+			return std::as_const(*this).GetRowwise(row, column);
+		}
+
+		T GetRowwise(I row, I column) const
 		{
 			assert(column >= 0 && column < columnCount);
 			assert(row >= 0 && row < rowCount);
 
-			for (int i = rows[row]; i < rows[row + 1]; i++)
+			if (!HasRows())
+			{
+				throw std::logic_error("row index is not built");
+			}
+
+			for (O i = rows[row]; i < rows[row + 1]; i++)
 			{
 				if (column == rowsColumns[i])
 				{
@@ -412,16 +422,25 @@ namespace spandex
 			return T();
 		}
 
-		void SetRowwise(int row, int column, const T& value)
+		void SetRowwise(I row, I column, const T& value)
 		{
 			assert(column >= 0 && column < columnCount);
 			assert(row >= 0 && row < rowCount);
 
-			for (int i = rows[row]; i < rows[row + 1]; i++)
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
+			for (O i = rows[row]; i < rows[row + 1]; i++)
 			{
 				if (column == rowsColumns[i])
 				{
 					values[positions[i]] = value;
+					if ((O)rowsValues.size() == nnz)
+					{
+						rowsValues[i] = value;
+					}
 					return;
 				}
 			}
@@ -429,12 +448,12 @@ namespace spandex
 			throw std::out_of_range("");
 		}
 
-		T GetColumnwise(int row, int column) const
+		T GetColumnwise(I row, I column) const
 		{
 			assert(column >= 0 && column < columnCount);
 			assert(row >= 0 && row < rowCount);
 
-			for (int i = columns[column]; i < columns[column + 1]; i++)
+			for (O i = columns[column]; i < columns[column + 1]; i++)
 			{
 				if (row == columnsRows[i])
 				{
@@ -445,16 +464,26 @@ namespace spandex
 			return T();
 		}
 
-		void SetColumnwise(int row, int column, const T& value)
+		void SetColumnwise(I row, I column, const T& value)
 		{
 			assert(column >= 0 && column < columnCount);
 			assert(row >= 0 && row < rowCount);
 
-			for (int i = columns[column]; i < columns[column + 1]; i++)
+			for (O i = columns[column]; i < columns[column + 1]; i++)
 			{
 				if (row == columnsRows[i])
 				{
 					values[i] = value;
+					if ((O)rowsValues.size() == nnz)
+					{
+						for (O k = rows[row]; k < rows[row + 1]; k++)
+						{
+							if (column == rowsColumns[k])
+							{
+								rowsValues[k] = value;
+							}
+						}
+					}
 					return;
 				}
 			}
@@ -463,7 +492,7 @@ namespace spandex
 		}
 
 	public:
-		SparseMatrix<T> Add(SparseMatrix<T>& b)
+		SparseMatrix<T, I, O> Add(SparseMatrix<T, I, O>& b)
 		{
 			assert(rowCount == b.rowCount);
 			assert(columnCount == b.columnCount);
@@ -473,22 +502,22 @@ namespace spandex
 			return std::move(c);
 		}
 
-		SparseMatrix<T> AddSym(SparseMatrix<T>& b)
+		SparseMatrix<T, I, O> AddSym(SparseMatrix<T, I, O>& b)
 		{
 			assert(rowCount == b.rowCount);
 			assert(columnCount == b.columnCount);
 
-			misc::CommonGraph<T> c(rowCount, nnz);
+			misc::CommonGraph<T, I> c(rowCount, (I)nnz);
 
 			list.Clear();
 
-			for (int j = 0; j < columnCount; j++)
+			for (I j = 0; j < columnCount; j++)
 			{
-				for (int i = columns[j]; i < columns[j + 1]; i++)
+				for (O i = columns[j]; i < columns[j + 1]; i++)
 				{
 					list.Push(columnsRows[i]);
 				}
-				for (int i = b.columns[j]; i < b.columns[j + 1]; i++)
+				for (O i = b.columns[j]; i < b.columns[j + 1]; i++)
 				{
 					list.Push(b.columnsRows[i]);
 				}
@@ -501,7 +530,7 @@ namespace spandex
 			return std::move(FromGraph(rowCount, columnCount, c));
 		}
 
-		void AddTo(SparseMatrix<T>& b, SparseMatrix<T>& c)
+		void AddTo(SparseMatrix<T, I, O>& b, SparseMatrix<T, I, O>& c)
 		{
 			assert(rowCount == b.rowCount);
 			assert(columnCount == b.columnCount);
@@ -510,28 +539,33 @@ namespace spandex
 
 			std::vector<T> acc(columnCount, (T)0);
 
-			for (int i = 0; i < rowCount; i++)
+			for (I i = 0; i < rowCount; i++)
 			{
-				for (int j = columns[i]; j < columns[i + 1]; j++)
+				for (O j = columns[i]; j < columns[i + 1]; j++)
 				{
 					acc[columnsRows[j]] = values[j];
 				}
 
-				for (int j = b.columns[i]; j < b.columns[i + 1]; j++)
+				for (O j = b.columns[i]; j < b.columns[i + 1]; j++)
 				{
 					acc[b.columnsRows[j]] += b.values[j];
 				}
 
-				for (int j = c.columns[i]; j < c.columns[i + 1]; j++)
+				for (O j = c.columns[i]; j < c.columns[i + 1]; j++)
 				{
-					int jj = c.columnsRows[j];
+					I jj = c.columnsRows[j];
 					c.values[j] = acc[jj];
 					acc[jj] = (T)0;
 				}
 			}
+
+			if (!c.rowsValues.empty())
+			{
+				c.SyncRows();
+			}
 		}
 
-		SparseMatrix<T> Mul(SparseMatrix<T>& b)
+		SparseMatrix<T, I, O> Mul(SparseMatrix<T, I, O>& b)
 		{
 			assert(columnCount == b.rowCount);
 
@@ -540,21 +574,21 @@ namespace spandex
 			return std::move(c);
 		}
 
-		SparseMatrix<T> MulSym(SparseMatrix<T>& b)
+		SparseMatrix<T, I, O> MulSym(SparseMatrix<T, I, O>& b)
 		{
 			assert(columnCount == b.rowCount);
 
 			list.Clear();
 
-			int initcap = (int)(nnz / 3);
-			misc::CommonGraph<T> c(rowCount, initcap);
+			I initcap = (I)(nnz / 3);
+			misc::CommonGraph<T, I> c(rowCount, initcap);
 
-			for (int j = 0; j < b.columnCount; j++)
+			for (I j = 0; j < b.columnCount; j++)
 			{
-				for (int i = b.columns[j]; i < b.columns[j + 1]; i++)
+				for (O i = b.columns[j]; i < b.columns[j + 1]; i++)
 				{
-					int ii = b.columnsRows[i];
-					for (int k = columns[ii]; k < columns[ii + 1]; k++)
+					I ii = b.columnsRows[i];
+					for (O k = columns[ii]; k < columns[ii + 1]; k++)
 					{
 						list.Push(columnsRows[k]);
 					}
@@ -569,7 +603,7 @@ namespace spandex
 			return FromGraph(rowCount, b.columnCount, c);
 		}
 
-		void MulTo(SparseMatrix<T>& b, SparseMatrix<T>& c)
+		void MulTo(SparseMatrix<T, I, O>& b, SparseMatrix<T, I, O>& c)
 		{
 			assert(rowCount == c.rowCount);
 			assert(columnCount == b.rowCount);
@@ -577,46 +611,253 @@ namespace spandex
 
 			std::vector<T> acc(c.rowCount, (T)0);
 
-			for (int j = 0; j < b.columnCount; j++)
+			for (I j = 0; j < b.columnCount; j++)
 			{
-				for (int i = b.columns[j]; i < b.columns[j + 1]; i++)
+				for (O i = b.columns[j]; i < b.columns[j + 1]; i++)
 				{
-					int ii = b.columnsRows[i];
-					for (int k = columns[ii]; k < columns[ii + 1]; k++)
+					I ii = b.columnsRows[i];
+					for (O k = columns[ii]; k < columns[ii + 1]; k++)
 					{
 						acc[columnsRows[k]] += b.values[i] * values[k];
 					}
 				}
 
-				for (int i = c.columns[j]; i < c.columns[j + 1]; i++)
+				for (O i = c.columns[j]; i < c.columns[j + 1]; i++)
 				{
-					int jj = c.columnsRows[i];
+					I jj = c.columnsRows[i];
 					c.values[i] = acc[jj];
 					acc[jj] = (T)0;
 				}
 			}
+
+			if (!c.rowsValues.empty())
+			{
+				c.SyncRows();
+			}
+		}
+
+		SparseMatrix<T, I, O> Mul(const SparseMatrix<T, I, O>& b, misc::ThreadPool& pool) const
+		{
+			assert(columnCount == b.rowCount);
+
+			I n = b.columnCount;
+
+			std::vector<long long> flops(1 + n, 0);
+			for (I j = 0; j < n; j++)
+			{
+				long long count = 0;
+				for (O i = b.columns[j]; i < b.columns[j + 1]; i++)
+				{
+					I ii = b.columnsRows[i];
+					count += columns[ii + 1] - columns[ii];
+				}
+				flops[j + 1] = flops[j] + count;
+			}
+
+			int parts = std::max(1, std::min(pool.size, (int)n));
+			std::vector<I> splits(parts + 1, n);
+			for (int t = 0; t < parts; t++)
+			{
+				long long target = flops[n] * t / parts;
+				splits[t] = (I)(std::lower_bound(flops.begin(), flops.end() - 1, target) - flops.begin());
+			}
+
+			std::vector<MulWorkspace> workspaces(parts);
+			std::vector<O> counts(1 + n, 0);
+
+			pool.Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						for (I j = splits[thread]; j < splits[thread + 1]; j++)
+						{
+							counts[j + 1] = (O)MulColumn(b, j, flops[j + 1] - flops[j], workspaces[thread], nullptr, nullptr);
+						}
+					}
+				});
+
+			for (I j = 0; j < n; j++)
+			{
+				counts[j + 1] += counts[j];
+			}
+
+			auto c = Empty(rowCount, n, counts[n]);
+			c.nnz = counts[n];
+			c.columns = std::move(counts);
+
+			pool.Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						for (I j = splits[thread]; j < splits[thread + 1]; j++)
+						{
+							O k = c.columns[j];
+							MulColumn(b, j, flops[j + 1] - flops[j], workspaces[thread], c.columnsRows.data() + k, c.values.data() + k);
+						}
+					}
+				});
+
+			c.BuildRows();
+
+			return std::move(c);
+		}
+
+		std::vector<T> Mul(const std::vector<T>& x) const
+		{
+			std::vector<T> y(rowCount);
+			MulTo(x, y);
+			return std::move(y);
+		}
+
+		void MulTo(std::span<const T> x, std::span<T> y) const
+		{
+			assert(columnCount == (I)x.size());
+			assert(rowCount == (I)y.size());
+
+			std::fill(y.begin(), y.end(), (T)0);
+
+			if (IsSymmetric())
+			{
+				MulSymmetricTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
+				return;
+			}
+
+			misc::Simd::AxpyTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
 		}
 
-		SparseMatrix<T> Sqr()
+		void MulTo(std::span<const T> x, std::span<T> y, misc::ThreadPool& pool) const
+		{
+			assert(columnCount == (I)x.size());
+			assert(rowCount == (I)y.size());
+
+			if (IsSymmetric())
+			{
+				MulSymmetricTo(x, y, pool);
+				return;
+			}
+
+			if (!HasRows() || (O)rowsValues.size() != nnz)
+			{
+				MulTo(x, y);
+				return;
+			}
+
+			auto segment = [&](I /*i*/, O from, O to)
+			{
+				T sum = (T)0;
+				for (O p = from; p < to; p++)
+				{
+					sum += rowsValues[p] * x[rowsColumns[p]];
+				}
+				return sum;
+			};
+
+			MergePathTo(pool, rows, rowCount, y.data(), segment, [&](I from, I to)
+				{
+					misc::Simd::DotTo(rows.data(), rowsColumns.data(), rowsValues.data(), x.data(), y.data(), from, to);
+				});
+		}
+
+		std::vector<T> MulTranspose(const std::vector<T>& x) const
+		{
+			std::vector<T> y(columnCount);
+			MulTransposeTo(x, y);
+			return std::move(y);
+		}
+
+		void MulTransposeTo(std::span<const T> x, std::span<T> y) const
+		{
+			assert(rowCount == (I)x.size());
+			assert(columnCount == (I)y.size());
+
+			if (IsSymmetric())
+			{
+				MulTo(x, y);
+				return;
+			}
+
+			misc::Simd::DotTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
+		}
+
+		void MulTransposeTo(std::span<const T> x, std::span<T> y, misc::ThreadPool& pool) const
+		{
+			assert(rowCount == (I)x.size());
+			assert(columnCount == (I)y.size());
+
+			if (IsSymmetric())
+			{
+				MulSymmetricTo(x, y, pool);
+				return;
+			}
+
+			auto segment = [&](I /*j*/, O from, O to)
+			{
+				T sum = (T)0;
+				for (O k = from; k < to; k++)
+				{
+					sum += values[k] * x[columnsRows[k]];
+				}
+				return sum;
+			};
+
+			MergePathTo(pool, columns, columnCount, y.data(), segment, [&](I from, I to)
+				{
+					misc::Simd::DotTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), from, to);
+				});
+		}
+
+		static void MulSymmetricTo(const O* starts, const I* indices, const T* values, const T* x, T* y, I from, I to)
+		{
+			for (I j = from; j < to; j++)
+			{
+				T xj = x[j];
+				T sum = (T)0;
+
+				for (O k = starts[j]; k < starts[j + 1]; k++)
+				{
+					I r = indices[k];
+					T v = values[k];
+
+					if (r == j)
+					{
+						sum += v * xj;
+					}
+					else
+					{
+						y[r] += v * xj;
+						sum += v * x[r];
+					}
+				}
+
+				y[j] += sum;
+			}
+		}
+
+		SparseMatrix<T, I, O> Sqr()
 		{
 			auto s = SqrSym();
 			SqrTo(s);
 			return std::move(s);
 		}
 
-		SparseMatrix<T> SqrSym()
+		SparseMatrix<T, I, O> SqrSym()
 		{
-			misc::CommonGraph<T> g(columnCount, columnCount);
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
+			misc::CommonGraph<T, I> g(columnCount, columnCount);
 			list.Clear();
 
-			for (int j = 0; j < columnCount; j++)
+			for (I j = 0; j < columnCount; j++)
 			{
-				for (int i = columns[j]; i < columns[j + 1]; i++)
+				for (O i = columns[j]; i < columns[j + 1]; i++)
 				{
-					int ii = columnsRows[i];
-					for (int k = rows[ii]; k < rows[ii + 1]; k++)
+					I ii = columnsRows[i];
+					for (O k = rows[ii]; k < rows[ii + 1]; k++)
 					{
-						int r = rowsColumns[k];
+						I r = rowsColumns[k];
 						list.Push(r);
 					}
 				}
@@ -634,73 +875,522 @@ namespace spandex
 			return std::move(ata);
 		}
 
-		void SqrTo(SparseMatrix<T>& ata)
+		void SqrTo(SparseMatrix<T, I, O>& ata)
 		{
 			assert(Layout::DefaultLayout == ata.layout);
 
+			if (!HasRows())
+			{
+				BuildRows();
+			}
+
 			std::vector<T> acc(columnCount);
 
-			for (int j = 0; j < columnCount; j++)
+			for (I j = 0; j < columnCount; j++)
 			{
-				for (int i = columns[j]; i < columns[j + 1]; i++)
+				for (O i = columns[j]; i < columns[j + 1]; i++)
 				{
-					int ii = columnsRows[i];
+					I ii = columnsRows[i];
 
-					for (int k = rows[ii]; k < rows[ii + 1]; k++)
+					for (O k = rows[ii]; k < rows[ii + 1]; k++)
 					{
-						int r = rowsColumns[k];
+						I r = rowsColumns[k];
 
 						acc[r] += values[i] * values[positions[k]];
 					}
 				}
 
-				for (int i = ata.columns[j]; i < ata.columns[j + 1]; i++)
+				for (O i = ata.columns[j]; i < ata.columns[j + 1]; i++)
 				{
-					int r = ata.columnsRows[i];
+					I r = ata.columnsRows[i];
 					ata.values[i] = acc[r];
 					acc[r] = T();
 				}
 			}
+
+			if (!ata.rowsValues.empty())
+			{
+				ata.SyncRows();
+			}
 		}
 
 	private:
-		template<class Key, class Value>
-		static void KeyValueSort(std::vector<Key>& keys, std::vector<Value>& values, int begin, int end)
+		struct MulWorkspace
+		{
+			std::vector<I> marks;
+			std::vector<T> dense;
+			std::vector<I> keys;
+			std::vector<T> sums;
+			std::vector<std::pair<I, T>> products;
+			std::vector<I> found;
+		};
+
+		long long MulColumn(const SparseMatrix<T, I, O>& b, I j, long long flops, MulWorkspace& ws, I* targetRows, T* targetValues) const
+		{
+			bool numeric = nullptr != targetValues;
+
+			auto forEach = [&](auto&& func)
+			{
+				for (O i = b.columns[j]; i < b.columns[j + 1]; i++)
+				{
+					I ii = b.columnsRows[i];
+					T bv = b.values[i];
+					for (O k = columns[ii]; k < columns[ii + 1]; k++)
+					{
+						func(columnsRows[k], bv, k);
+					}
+				}
+			};
+
+			ws.found.clear();
+
+			if (flops <= 32)
+			{
+				ws.products.clear();
+				forEach([&](I r, T bv, O k)
+					{
+						ws.products.emplace_back(r, numeric ? bv * values[k] : (T)0);
+					});
+				std::stable_sort(ws.products.begin(), ws.products.end(),
+					[](const std::pair<I, T>& x, const std::pair<I, T>& y) { return x.first < y.first; });
+
+				long long count = 0;
+				for (size_t p = 0; p < ws.products.size();)
+				{
+					I r = ws.products[p].first;
+					T sum = (T)0;
+					for (; p < ws.products.size() && r == ws.products[p].first; p++)
+					{
+						sum += ws.products[p].second;
+					}
+					if (numeric)
+					{
+						targetRows[count] = r;
+						targetValues[count] = sum;
+					}
+					count += 1;
+				}
+				return count;
+			}
+
+			if (flops * 8 >= rowCount)
+			{
+				if ((I)ws.marks.size() != rowCount)
+				{
+					ws.marks.assign(rowCount, -1);
+					ws.dense.assign(rowCount, (T)0);
+				}
+
+				forEach([&](I r, T bv, O k)
+					{
+						if (j != ws.marks[r])
+						{
+							ws.marks[r] = j;
+							ws.found.push_back(r);
+						}
+						if (numeric)
+						{
+							ws.dense[r] += bv * values[k];
+						}
+					});
+
+				for (I r : ws.found)
+				{
+					ws.marks[r] = -1;
+				}
+			}
+			else
+			{
+				size_t size = 1;
+				while (size < (size_t)flops * 2)
+				{
+					size <<= 1;
+				}
+				size_t mask = size - 1;
+
+				ws.keys.assign(size, -1);
+				if (numeric)
+				{
+					ws.sums.assign(size, (T)0);
+				}
+
+				forEach([&](I r, T bv, O k)
+					{
+						size_t h = ((size_t)r * 2654435761u) & mask;
+						while (-1 != ws.keys[h] && r != ws.keys[h])
+						{
+							h = (h + 1) & mask;
+						}
+						if (-1 == ws.keys[h])
+						{
+							ws.keys[h] = r;
+							ws.found.push_back(r);
+						}
+						if (numeric)
+						{
+							ws.sums[h] += bv * values[k];
+						}
+					});
+			}
+
+			if (!numeric)
+			{
+				return (long long)ws.found.size();
+			}
+
+			std::sort(ws.found.begin(), ws.found.end());
+
+			bool hashed = flops * 8 < rowCount;
+			size_t mask = ws.keys.size() - 1;
+
+			for (size_t p = 0; p < ws.found.size(); p++)
+			{
+				I r = ws.found[p];
+				targetRows[p] = r;
+
+				if (hashed)
+				{
+					size_t h = ((size_t)r * 2654435761u) & mask;
+					while (r != ws.keys[h])
+					{
+						h = (h + 1) & mask;
+					}
+					targetValues[p] = ws.sums[h];
+				}
+				else
+				{
+					targetValues[p] = ws.dense[r];
+					ws.dense[r] = (T)0;
+				}
+			}
+
+			return (long long)ws.found.size();
+		}
+
+		bool IsSymmetric() const
+		{
+			return Layout::LowerSymmetric == layout || Layout::UpperSymmetric == layout;
+		}
+
+		void MulSymmetricTo(std::span<const T> x, std::span<T> y, misc::ThreadPool& pool) const
+		{
+			int parts = std::max(1, std::min(pool.size, (int)columnCount));
+
+			std::vector<I> splits(parts + 1, columnCount);
+			for (int t = 0; t < parts; t++)
+			{
+				O target = (O)((long long)columns[columnCount] * t / parts);
+				splits[t] = (I)(std::lower_bound(columns.begin(), columns.end() - 1, target) - columns.begin());
+			}
+
+			std::vector<std::vector<T>> buffers(parts);
+			pool.Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						buffers[thread].assign(rowCount, (T)0);
+						MulSymmetricTo(columns.data(), columnsRows.data(), values.data(), x.data(), buffers[thread].data(), splits[thread], splits[thread + 1]);
+					}
+				});
+
+			pool.For(0, (int)rowCount, [&](int /*thread*/, int from, int to)
+				{
+					for (I i = (I)from; i < (I)to; i++)
+					{
+						T sum = (T)0;
+						for (int t = 0; t < parts; t++)
+						{
+							sum += buffers[t][i];
+						}
+						y[i] = sum;
+					}
+				});
+		}
+
+		template<class Segment, class Full>
+		static void MergePathTo(misc::ThreadPool& pool, const std::vector<O>& starts, I count, T* y, Segment&& segment, Full&& full)
+		{
+			long long total = (long long)count + starts[count];
+			int parts = (int)std::max(1LL, std::min((long long)pool.size, total));
+
+			std::vector<I> carryRows(parts, count);
+			std::vector<T> carries(parts, (T)0);
+
+			pool.Run([&](int thread)
+				{
+					if (thread >= parts)
+					{
+						return;
+					}
+
+					auto [i0, k0] = MergePathSearch(starts, count, total * thread / parts);
+					auto [i1, k1] = MergePathSearch(starts, count, total * (thread + 1) / parts);
+
+					if (i0 < i1)
+					{
+						y[i0] = segment(i0, k0, starts[i0 + 1]);
+						full(i0 + 1, i1);
+						k0 = starts[i1];
+					}
+					if (i1 < count)
+					{
+						carryRows[thread] = i1;
+						carries[thread] = segment(i1, k0, k1);
+					}
+				});
+
+			for (int t = 0; t < parts; t++)
+			{
+				if (carryRows[t] < count)
+				{
+					y[carryRows[t]] += carries[t];
+				}
+			}
+		}
+
+		static std::pair<I, O> MergePathSearch(const std::vector<O>& starts, I count, long long diagonal)
 		{
-			assert(keys.size() == values.size());
-			assert(begin >= 0);
-			assert(end >= begin && end <= (int)keys.size());
+			long long nnz = starts[count];
+			long long lo = std::max(0LL, diagonal - nnz);
+			long long hi = std::min(diagonal, (long long)count);
 
-			std::vector<int> indices(end - begin);
-			std::iota(std::begin(indices), std::end(indices), begin);
+			while (lo < hi)
+			{
+				long long mid = (lo + hi) / 2;
+				if (starts[mid + 1] <= diagonal - 1 - mid)
+				{
+					lo = mid + 1;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
 
-			std::vector<int> sorted = indices;
-			std::sort(std::begin(sorted), std::end(sorted),
-				[&](int a, int b) { return keys[a] < keys[b]; });
+			return { (I)lo, (O)(diagonal - lo) };
+		}
 
-			Reindex(values, indices, sorted);
-			Reindex(keys, indices, sorted);
+		static SparseMatrix<T, I, O> FromCSR(I rowCount, I columnCount,
+			const std::vector<O>& rows, const std::vector<I>& columns, const std::vector<T>& values, misc::ThreadPool* pool)
+		{
+			assert(rowCount == ((I)rows.size() - 1));
+			assert(values.size() == columns.size());
+			assert((O)values.size() == rows.back());
+
+			auto sparse = SparseMatrix<T, I, O>::Empty(rowCount, columnCount, (O)values.size());
+			sparse.nnz = (O)values.size();
+
+			std::vector<O> sources(sparse.nnz);
+			TransposeTo(rowCount, columnCount, rows, columns.data(), sparse.columns, sparse.columnsRows.data(), sources.data(), pool);
+
+			ForRange(pool, sparse.nnz, [&](O from, O to)
+				{
+					for (O k = from; k < to; k++)
+					{
+						sparse.values[k] = values[sources[k]];
+					}
+				});
+
+			sparse.BuildRows(pool);
+
+			return std::move(sparse);
 		}
 
-		template<class Y>
-		static void Reindex(std::vector<Y>& values,
-			const std::vector<int>& oldIndices, const std::vector<int>& newIndices)
+		static SparseMatrix<T, I, O> FromGraph(I rowCount, I columnCount, misc::CommonGraph<T, I>& graph, misc::ThreadPool* pool)
 		{
-			assert(oldIndices.size() == newIndices.size());
-			assert(oldIndices.size() <= values.size());
+			std::vector<O> rows(1 + rowCount, 0);
+			std::vector<I> columns(graph.size);
+			std::vector<T> values(graph.size);
 
-			int n = (int)oldIndices.size();
-			std::vector<Y> t = values;
+			auto it = graph.GetIterator();
+			O k = 0;
+			for (I i = 0; i < rowCount; i++)
+			{
+				it.Setup(i);
+				while (it.HasNext())
+				{
+					auto item = it.Next();
 
-			for (int i = 0; i < n; i++)
+					columns[k] = item.first;
+					values[k] = item.second;
+
+					k += 1;
+				}
+				rows[i + 1] = k;
+			}
+
+			return std::move(FromCSR(rowCount, columnCount, rows, columns, values, pool));
+		}
+
+		void Sort(misc::ThreadPool* pool)
+		{
+			bool sorted = true;
+			for (I j = 0; j < columnCount && sorted; j++)
 			{
-				t[i] = values[oldIndices[i]];
+				for (O i = columns[j] + 1; i < columns[j + 1]; i++)
+				{
+					if (columnsRows[i - 1] > columnsRows[i])
+					{
+						sorted = false;
+						break;
+					}
+				}
 			}
 
-			for (int i = 0; i < n; i++)
+			if (!sorted)
 			{
-				values[newIndices[i]] = t[i];
+				std::vector<O> starts;
+				std::vector<I> minors(nnz);
+				std::vector<O> sources(nnz);
+				TransposeTo(columnCount, rowCount, columns, columnsRows.data(), starts, minors.data(), sources.data(), pool);
+
+				std::vector<O> order(nnz);
+				TransposeTo(rowCount, columnCount, starts, minors.data(), columns, columnsRows.data(), order.data(), pool);
+
+				std::vector<T> t(nnz);
+				ForRange(pool, nnz, [&](O from, O to)
+					{
+						for (O k = from; k < to; k++)
+						{
+							t[k] = values[sources[order[k]]];
+						}
+					});
+				values.swap(t);
 			}
+
+			BuildRows(pool);
+		}
+
+		void BuildRows(misc::ThreadPool* pool)
+		{
+			rowsColumns.resize(nnz);
+			positions.resize(nnz);
+
+			TransposeTo(columnCount, rowCount, columns, columnsRows.data(), rows, rowsColumns.data(), positions.data(), pool);
+
+			SyncRows(pool);
+		}
+
+		void SyncRows(misc::ThreadPool* pool)
+		{
+			if (IsSymmetric() || !HasRows())
+			{
+				std::vector<T>().swap(rowsValues);
+				return;
+			}
+
+			rowsValues.resize(nnz);
+			ForRange(pool, nnz, [&](O from, O to)
+				{
+					for (O k = from; k < to; k++)
+					{
+						rowsValues[k] = values[positions[k]];
+					}
+				});
+		}
+
+		template<class Func>
+		static void ForRange(misc::ThreadPool* pool, O count, Func&& func)
+		{
+			if (nullptr == pool || count < 4096)
+			{
+				func((O)0, count);
+				return;
+			}
+
+			int parts = pool->size;
+			pool->Run([&](int thread)
+				{
+					func((O)((long long)count * thread / parts), (O)((long long)count * (thread + 1) / parts));
+				});
+		}
+
+		static void TransposeTo(I majorCount, I minorCount, const std::vector<O>& starts, const I* minors,
+			std::vector<O>& targetStarts, I* targetMinors, O* targetSources, misc::ThreadPool* pool)
+		{
+			O count = starts[majorCount];
+
+			int parts = 1;
+			if (nullptr != pool && count >= 4096)
+			{
+				parts = std::max(1, std::min(pool->size, (int)majorCount));
+			}
+
+			std::vector<I> splits(parts + 1, majorCount);
+			for (int t = 0; t < parts; t++)
+			{
+				O target = (O)((long long)count * t / parts);
+				splits[t] = (I)(std::lower_bound(starts.begin(), starts.end() - 1, target) - starts.begin());
+			}
+
+			targetStarts.assign(1 + minorCount, 0);
+
+			if (1 == parts)
+			{
+				for (O k = 0; k < count; k++)
+				{
+					targetStarts[minors[k] + 1] += 1;
+				}
+				for (I i = 0; i < minorCount; i++)
+				{
+					targetStarts[i + 1] += targetStarts[i];
+				}
+
+				std::vector<O> next(targetStarts.begin(), targetStarts.end() - 1);
+				for (I j = 0; j < majorCount; j++)
+				{
+					for (O k = starts[j]; k < starts[j + 1]; k++)
+					{
+						O p = next[minors[k]]++;
+						targetMinors[p] = j;
+						targetSources[p] = k;
+					}
+				}
+				return;
+			}
+
+			std::vector<std::vector<O>> counts(parts);
+			pool->Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						counts[thread].assign(minorCount, 0);
+						for (O k = starts[splits[thread]]; k < starts[splits[thread + 1]]; k++)
+						{
+							counts[thread][minors[k]] += 1;
+						}
+					}
+				});
+
+			O offset = 0;
+			for (I i = 0; i < minorCount; i++)
+			{
+				targetStarts[i] = offset;
+				for (int t = 0; t < parts; t++)
+				{
+					O c = counts[t][i];
+					counts[t][i] = offset;
+					offset += c;
+				}
+			}
+			targetStarts[minorCount] = offset;
+
+			pool->Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						auto& next = counts[thread];
+						for (I j = splits[thread]; j < splits[thread + 1]; j++)
+						{
+							for (O k = starts[j]; k < starts[j + 1]; k++)
+							{
+								O p = next[minors[k]]++;
+								targetMinors[p] = j;
+								targetSources[p] = k;
+							}
+						}
+					}
+				});
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "SparseMatrix.h"
+
+#include "misc/Simd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace spandex
+{
+	template<class T, class I = int, class O = I>
+	class SparseMatrixView
+	{
+	public:
+		std::span<const O> columns;
+		std::span<const I> columnsRows;
+		std::span<const T> values;
+
+		std::span<const O> rows;
+		std::span<const I> rowsColumns;
+		std::span<const O> positions;
+
+		Layout layout;
+		O nnz;
+		I rowCount;
+		I columnCount;
+
+		std::shared_ptr<const void> owner;
+
+		SparseMatrixView() : layout(Layout::DefaultLayout), nnz(0), rowCount(0), columnCount(0)
+		{
+		}
+
+		static SparseMatrixView<T, I, O> FromMatrix(const SparseMatrix<T, I, O>& a)
+		{
+			SparseMatrixView<T, I, O> view;
+			view.columns = a.columns;
+			view.columnsRows = std::span<const I>(a.columnsRows.data(), a.nnz);
+			view.values = std::span<const T>(a.values.data(), a.nnz);
+			if (a.HasRows())
+			{
+				view.rows = a.rows;
+				view.rowsColumns = std::span<const I>(a.rowsColumns.data(), a.nnz);
+				view.positions = std::span<const O>(a.positions.data(), a.nnz);
+			}
+			view.layout = a.layout;
+			view.nnz = a.nnz;
+			view.rowCount = a.rowCount;
+			view.columnCount = a.columnCount;
+
+			return std::move(view);
+		}
+
+		bool HasRows() const
+		{
+			return (I)rows.size() == 1 + rowCount;
+		}
+
+		bool IsValid() const
+		{
+			if (!IsValid(columns, columnsRows, nnz, rowCount))
+			{
+				return false;
+			}
+
+			return !HasRows() || (IsValid(rows, rowsColumns, nnz, columnCount) && IsValid(positions, nnz));
+		}
+
+		SparseMatrix<T, I, O> ToMatrix() const
+		{
+			auto a = SparseMatrix<T, I, O>::Empty(rowCount, columnCount, 0);
+			a.layout = layout;
+			a.nnz = nnz;
+			a.columns.assign(columns.begin(), columns.end());
+			a.columnsRows.assign(columnsRows.begin(), columnsRows.end());
+			a.values.assign(values.begin(), values.end());
+
+			if (HasRows())
+			{
+				a.rows.assign(rows.begin(), rows.end());
+				a.rowsColumns.assign(rowsColumns.begin(), rowsColumns.end());
+				a.positions.assign(positions.begin(), positions.end());
+				a.SyncRows();
+			}
+			else
+			{
+				a.DropRows();
+			}
+
+			return std::move(a);
+		}
+
+		void MulTo(std::span<const T> x, std::span<T> y) const
+		{
+			assert(columnCount == (I)x.size());
+			assert(rowCount == (I)y.size());
+
+			std::fill(y.begin(), y.end(), (T)0);
+
+			if (Layout::LowerSymmetric == layout || Layout::UpperSymmetric == layout)
+			{
+				SparseMatrix<T, I, O>::MulSymmetricTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
+				return;
+			}
+
+			misc::Simd::AxpyTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
+		}
+
+		void MulTransposeTo(std::span<const T> x, std::span<T> y) const
+		{
+			assert(rowCount == (I)x.size());
+			assert(columnCount == (I)y.size());
+
+			if (Layout::LowerSymmetric == layout || Layout::UpperSymmetric == layout)
+			{
+				MulTo(x, y);
+				return;
+			}
+
+			misc::Simd::DotTo(columns.data(), columnsRows.data(), values.data(), x.data(), y.data(), (I)0, columnCount);
+		}
+
+	private:
+		template<class Y>
+		static bool IsValid(std::span<const O> starts, std::span<const Y> indices, O count, Y bound)
+		{
+			if (starts.empty() || 0 != starts.front() || count != starts.back() || (O)indices.size() != count)
+			{
+				return false;
+			}
+			for (size_t j = 1; j < starts.size(); j++)
+			{
+				if (starts[j] < starts[j - 1])
+				{
+					return false;
+				}
+			}
+
+			return IsValid(indices, bound);
+		}
+
+		template<class Y>
+		static bool IsValid(std::span<const Y> indices, Y bound)
+		{
+			for (Y i : indices)
+			{
+				if (i < 0 || i >= bound)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+}
\ No newline at end of file
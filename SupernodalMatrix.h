@@ -0,0 +1,453 @@
+#pragma once
+
+#include "SparseMatrix.h"
+#include "EliminationTree.h"
+
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+namespace spandex
+{
+	template<class T, class I = int, class O = I>
+	class SupernodalMatrix
+	{
+	public:
+		std::vector<I> supernodes;
+		std::vector<I> columnsSupernodes;
+
+		std::vector<O> rows;
+		std::vector<I> supernodesRows;
+
+		std::vector<O> panels;
+		std::vector<T> values;
+
+		std::vector<O> updates;
+		std::vector<I> updatesSupernodes;
+		std::vector<I> updatesPositions;
+
+		I count;
+		I size;
+
+	private:
+		std::vector<I> relative;
+		std::vector<T> work;
+
+	public:
+		SupernodalMatrix() : count(0), size(0)
+		{
+		}
+
+		static SupernodalMatrix<T, I, O> FromPattern(const SparseMatrix<T, I, O>& ld, double relaxation = 0.05, I relaxedWidth = 4)
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+
+			I n = ld.columnCount;
+
+			SupernodalMatrix<T, I, O> sm;
+			sm.size = n;
+			sm.columnsSupernodes.resize(n);
+			sm.supernodes.push_back(0);
+			sm.rows.push_back(0);
+
+			for (I f = 0; f < n;)
+			{
+				I l = f;
+				long long actual = ColumnCount(ld, f);
+
+				while (l + 1 < n && Parent(ld, l) == l + 1)
+				{
+					I c = l + 1;
+					long long width = c - f + 1;
+					long long height = width + ColumnCount(ld, c) - 1;
+					long long stored = width * height - width * (width - 1) / 2;
+					long long zeros = stored - (actual + ColumnCount(ld, c));
+
+					if (0 != zeros && width > relaxedWidth && zeros > relaxation * stored)
+					{
+						break;
+					}
+
+					actual += ColumnCount(ld, c);
+					l = c;
+				}
+
+				for (I j = f; j <= l; j++)
+				{
+					sm.columnsSupernodes[j] = sm.count;
+					sm.supernodesRows.push_back(j);
+				}
+				for (O i = ld.columns[l] + 1; i < ld.columns[l + 1]; i++)
+				{
+					sm.supernodesRows.push_back(ld.columnsRows[i]);
+				}
+
+				sm.count += 1;
+				sm.supernodes.push_back(l + 1);
+				sm.rows.push_back((O)sm.supernodesRows.size());
+
+				f = l + 1;
+			}
+
+			sm.panels.resize(1 + sm.count, 0);
+			for (I s = 0; s < sm.count; s++)
+			{
+				sm.panels[s + 1] = sm.panels[s] + (O)sm.GetWidth(s) * sm.GetHeight(s);
+			}
+			sm.values.resize(sm.panels[sm.count]);
+
+			sm.BuildUpdates();
+
+			return std::move(sm);
+		}
+
+		I GetWidth(I supernode) const
+		{
+			return supernodes[supernode + 1] - supernodes[supernode];
+		}
+
+		I GetHeight(I supernode) const
+		{
+			return (I)(rows[supernode + 1] - rows[supernode]);
+		}
+
+		I GetParent(I supernode) const
+		{
+			O i = rows[supernode] + GetWidth(supernode);
+
+			return i < rows[supernode + 1] ? columnsSupernodes[supernodesRows[i]] : -1;
+		}
+
+		void CholTo(SparseMatrix<T, I, O>& sym, T tolerance)
+		{
+			assert(Layout::LowerSymmetric == sym.layout);
+			assert(size == sym.columnCount);
+
+			relative.resize(size);
+
+			for (I s = 0; s < count; s++)
+			{
+				CholSupernode(sym, s, tolerance, relative, work);
+			}
+		}
+
+		void CholTo(SparseMatrix<T, I, O>& sym, T tolerance, misc::ThreadPool& pool, I parallelHeight = 256)
+		{
+			assert(Layout::LowerSymmetric == sym.layout);
+			assert(size == sym.columnCount);
+
+			std::vector<I> parent(count);
+			std::vector<double> cost(count);
+			for (I s = 0; s < count; s++)
+			{
+				parent[s] = GetParent(s);
+
+				double m = GetHeight(s);
+				cost[s] = m * m * GetWidth(s);
+			}
+
+			std::vector<I> tasks, tasksNodes, top;
+			BasicEliminationTree<I>::Schedule(parent, cost, pool.size, tasks, tasksNodes, top);
+
+			std::atomic<int> next(0);
+			pool.Run([&](int /*thread*/)
+				{
+					std::vector<I> relative(size);
+					std::vector<T> work;
+
+					for (int t = next++; t < (int)tasks.size() - 1; t = next++)
+					{
+						for (I i = tasks[t]; i < tasks[t + 1]; i++)
+						{
+							CholSupernode(sym, tasksNodes[i], tolerance, relative, work);
+						}
+					}
+				});
+
+			std::vector<I> relative(size);
+			std::vector<std::vector<T>> works(pool.size);
+
+			for (I s : top)
+			{
+				O m = GetHeight(s);
+				if (m < parallelHeight)
+				{
+					CholSupernode(sym, s, tolerance, relative, works[0]);
+					continue;
+				}
+
+				I w = GetWidth(s);
+				T* panel = &values[panels[s]];
+
+				SetRelative(s, relative);
+
+				pool.For(0, (int)m, [&](int thread, int from, int to)
+					{
+						Assemble(sym, s, relative, from, to);
+						Update(s, relative, works[thread], from, to);
+					});
+
+				FactorKernel(panel, m, w, 0, w, tolerance);
+
+				pool.For(w, (int)m, [&](int /*thread*/, int from, int to)
+					{
+						FactorKernel(panel, m, w, from, to, tolerance);
+					});
+			}
+		}
+
+		void CopyTo(SparseMatrix<T, I, O>& ld) const
+		{
+			assert(Layout::LowerTriangle == ld.layout);
+			assert(size == ld.columnCount);
+
+			for (I s = 0; s < count; s++)
+			{
+				O m = GetHeight(s);
+				const I* panelRows = &supernodesRows[rows[s]];
+				const T* panel = &values[panels[s]];
+
+				for (I c = 0, j = supernodes[s]; j < supernodes[s + 1]; c++, j++)
+				{
+					I r = c;
+					for (O k = ld.columns[j]; k < ld.columns[j + 1]; k++)
+					{
+						while (panelRows[r] != ld.columnsRows[k])
+						{
+							r += 1;
+						}
+						ld.values[k] = panel[r + c * m];
+					}
+				}
+			}
+		}
+
+	private:
+		static I Parent(const SparseMatrix<T, I, O>& ld, I column)
+		{
+			O i = ld.columns[column] + 1;
+
+			return i < ld.columns[column + 1] ? ld.columnsRows[i] : -1;
+		}
+
+		static long long ColumnCount(const SparseMatrix<T, I, O>& ld, I column)
+		{
+			return ld.columns[column + 1] - ld.columns[column];
+		}
+
+		void BuildUpdates()
+		{
+			updates.assign(1 + count, 0);
+
+			for (I k = 0; k < count; k++)
+			{
+				I previous = -1;
+				for (O i = rows[k] + GetWidth(k); i < rows[k + 1]; i++)
+				{
+					I s = columnsSupernodes[supernodesRows[i]];
+					if (s != previous)
+					{
+						updates[s + 1] += 1;
+						previous = s;
+					}
+				}
+			}
+
+			for (I s = 0; s < count; s++)
+			{
+				updates[s + 1] += updates[s];
+			}
+
+			updatesSupernodes.resize(updates[count]);
+			updatesPositions.resize(updates[count]);
+
+			std::vector<O> next(updates.begin(), updates.end() - 1);
+			for (I k = 0; k < count; k++)
+			{
+				I previous = -1;
+				for (O i = rows[k] + GetWidth(k); i < rows[k + 1]; i++)
+				{
+					I s = columnsSupernodes[supernodesRows[i]];
+					if (s != previous)
+					{
+						updatesSupernodes[next[s]] = k;
+						updatesPositions[next[s]] = i - rows[k];
+						next[s] += 1;
+						previous = s;
+					}
+				}
+			}
+		}
+
+		void CholSupernode(SparseMatrix<T, I, O>& sym, I s, T tolerance, std::vector<I>& relative, std::vector<T>& work)
+		{
+			O m = GetHeight(s);
+
+			SetRelative(s, relative);
+			Assemble(sym, s, relative, 0, m);
+			Update(s, relative, work, 0, m);
+			FactorKernel(&values[panels[s]], m, GetWidth(s), 0, m, tolerance);
+		}
+
+		void SetRelative(I s, std::vector<I>& relative) const
+		{
+			for (O i = rows[s]; i < rows[s + 1]; i++)
+			{
+				relative[supernodesRows[i]] = i - rows[s];
+			}
+		}
+
+		void Assemble(SparseMatrix<T, I, O>& sym, I s, const std::vector<I>& relative, I from, I to)
+		{
+			I f = supernodes[s];
+			O m = GetHeight(s);
+			T* panel = &values[panels[s]];
+
+			for (I c = 0, j = f; j < supernodes[s + 1]; c++, j++)
+			{
+				std::fill(panel + c * m + from, panel + c * m + to, T());
+
+				for (O i = sym.columns[j]; i < sym.columns[j + 1]; i++)
+				{
+					I r = relative[sym.columnsRows[i]];
+					if (r >= from && r < to)
+					{
+						panel[r + c * m] = sym.values[i];
+					}
+				}
+			}
+		}
+
+		void Update(I s, const std::vector<I>& relative, std::vector<T>& work, I from, I to)
+		{
+			I f = supernodes[s];
+			I l = supernodes[s + 1];
+			O m = GetHeight(s);
+			T* panel = &values[panels[s]];
+
+			for (O u = updates[s]; u < updates[s + 1]; u++)
+			{
+				I k = updatesSupernodes[u];
+				I position = updatesPositions[u];
+				O mk = GetHeight(k);
+				const I* kRows = &supernodesRows[rows[k]];
+
+				I q = 0;
+				while (position + q < mk && kRows[position + q] < l)
+				{
+					q += 1;
+				}
+				I r = mk - position;
+
+				I begin = 0;
+				while (begin < r && relative[kRows[position + begin]] < from)
+				{
+					begin += 1;
+				}
+				I end = begin;
+				while (end < r && relative[kRows[position + end]] < to)
+				{
+					end += 1;
+				}
+				if (begin == end)
+				{
+					continue;
+				}
+
+				work.resize((size_t)r * q);
+				UpdateKernel(&values[panels[k]], mk, GetWidth(k), position, r, q, begin, end, work.data());
+
+				for (I cc = 0; cc < q; cc++)
+				{
+					T* target = panel + (kRows[position + cc] - f) * m;
+					const T* source = work.data() + (O)cc * r;
+
+					for (I i = std::max(cc, begin); i < end; i++)
+					{
+						target[relative[kRows[position + i]]] -= source[i];
+					}
+				}
+			}
+		}
+
+		static void UpdateKernel(const T* panel, O m, I w, I position, I r, I q, I begin, I end, T* work)
+		{
+			for (I cc = 0; cc < q; cc++)
+			{
+				T* target = work + (O)cc * r;
+				const T* lower = panel + position;
+				I from = std::max(cc, begin);
+				if (from >= end)
+				{
+					continue;
+				}
+
+				std::fill(target + from, target + end, T());
+
+				I k = 0;
+				for (; k + 4 <= w; k += 4)
+				{
+					const T* c0 = lower + k * m;
+					const T* c1 = c0 + m;
+					const T* c2 = c1 + m;
+					const T* c3 = c2 + m;
+
+					T a0 = c0[cc] * panel[k + k * m];
+					T a1 = c1[cc] * panel[(k + 1) + (k + 1) * m];
+					T a2 = c2[cc] * panel[(k + 2) + (k + 2) * m];
+					T a3 = c3[cc] * panel[(k + 3) + (k + 3) * m];
+
+					for (I i = from; i < end; i++)
+					{
+						target[i] += c0[i] * a0 + c1[i] * a1 + c2[i] * a2 + c3[i] * a3;
+					}
+				}
+				for (; k < w; k++)
+				{
+					const T* c0 = lower + k * m;
+					T a0 = c0[cc] * panel[k + k * m];
+
+					for (I i = from; i < end; i++)
+					{
+						target[i] += c0[i] * a0;
+					}
+				}
+			}
+		}
+
+		static void FactorKernel(T* panel, O m, I w, I from, I to, T tolerance)
+		{
+			const T zero = (T)0;
+
+			for (I c = 0; c < w; c++)
+			{
+				T* target = panel + c * m;
+
+				for (I k = 0; k < c; k++)
+				{
+					const T* source = panel + k * m;
+					T a = source[c] * source[k];
+
+					for (I i = std::max(c, from); i < to; i++)
+					{
+						target[i] -= source[i] * a;
+					}
+				}
+
+				T d = target[c];
+				if (d <= zero)
+				{
+					d = tolerance;
+				}
+
+				for (I i = std::max(c + 1, from); i < to; i++)
+				{
+					target[i] /= d;
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
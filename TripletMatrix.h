@@ -0,0 +1,262 @@
+#pragma once
+
+#include "SparseMatrix.h"
+
+#include "misc/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <vector>
+
+namespace spandex
+{
+	template<class T, class I = int, class O = I>
+	class AssemblyMap
+	{
+	public:
+		std::vector<O> slots;
+		std::vector<O> sources;
+		std::vector<O> batches;
+
+		O GetSize() const
+		{
+			return (O)sources.size();
+		}
+
+		O GetOffset(int thread) const
+		{
+			assert(thread >= 0 && thread + 1 < (int)batches.size());
+
+			return batches[thread];
+		}
+
+		void AssembleTo(std::span<const T> contributions, SparseMatrix<T, I, O>& a) const
+		{
+			assert(GetSize() == (O)contributions.size());
+			assert(a.nnz + 1 == (O)slots.size());
+
+			AssembleTo(contributions, a, 0, a.nnz);
+		}
+
+		void AssembleTo(std::span<const T> contributions, SparseMatrix<T, I, O>& a, misc::ThreadPool& pool) const
+		{
+			assert(GetSize() == (O)contributions.size());
+			assert(a.nnz + 1 == (O)slots.size());
+
+			int parts = pool.size;
+			pool.Run([&](int thread)
+				{
+					O from = (O)((long long)a.nnz * thread / parts);
+					O to = (O)((long long)a.nnz * (thread + 1) / parts);
+					AssembleTo(contributions, a, from, to);
+				});
+		}
+
+	private:
+		void AssembleTo(std::span<const T> contributions, SparseMatrix<T, I, O>& a, O from, O to) const
+		{
+			for (O s = from; s < to; s++)
+			{
+				O p = slots[s];
+				T sum = contributions[sources[p]];
+				for (p += 1; p < slots[s + 1]; p++)
+				{
+					sum += contributions[sources[p]];
+				}
+				a.values[s] = sum;
+			}
+		}
+	};
+
+	template<class T, class I = int, class O = I>
+	class TripletMatrix
+	{
+	public:
+		struct Batch
+		{
+			std::vector<I> rows;
+			std::vector<I> columns;
+			std::vector<T> values;
+		};
+
+		std::vector<Batch> batches;
+
+		I rowCount;
+		I columnCount;
+
+		TripletMatrix(I rowCount, I columnCount, int threadCount = 1) : batches(std::max(1, threadCount)),
+			rowCount(rowCount), columnCount(columnCount)
+		{
+		}
+
+		void Reserve(O capacity, int thread = 0)
+		{
+			assert(thread >= 0 && thread < (int)batches.size());
+
+			auto& batch = batches[thread];
+			batch.rows.reserve(capacity);
+			batch.columns.reserve(capacity);
+			batch.values.reserve(capacity);
+		}
+
+		void Insert(I row, I column, const T& value, int thread = 0)
+		{
+			assert(row >= 0 && row < rowCount);
+			assert(column >= 0 && column < columnCount);
+			assert(thread >= 0 && thread < (int)batches.size());
+
+			auto& batch = batches[thread];
+			batch.rows.push_back(row);
+			batch.columns.push_back(column);
+			batch.values.push_back(value);
+		}
+
+		void Insert(const std::vector<I>& rows, const std::vector<I>& columns, const std::vector<T>& values, int thread = 0)
+		{
+			assert(rows.size() == columns.size());
+			assert(rows.size() == values.size());
+			assert(thread >= 0 && thread < (int)batches.size());
+
+			auto& batch = batches[thread];
+			batch.rows.insert(batch.rows.end(), rows.begin(), rows.end());
+			batch.columns.insert(batch.columns.end(), columns.begin(), columns.end());
+			batch.values.insert(batch.values.end(), values.begin(), values.end());
+		}
+
+		O GetSize() const
+		{
+			O size = 0;
+			for (auto& batch : batches)
+			{
+				size += (O)batch.rows.size();
+			}
+
+			return size;
+		}
+
+		void Clear()
+		{
+			for (auto& batch : batches)
+			{
+				batch.rows.clear();
+				batch.columns.clear();
+				batch.values.clear();
+			}
+		}
+
+		SparseMatrix<T, I, O> ToMatrix() const
+		{
+			AssemblyMap<T, I, O> map;
+
+			return std::move(ToMatrix(map));
+		}
+
+		SparseMatrix<T, I, O> ToMatrix(AssemblyMap<T, I, O>& map) const
+		{
+			O size = GetSize();
+
+			map.batches.assign(1 + batches.size(), 0);
+			for (size_t b = 0; b < batches.size(); b++)
+			{
+				map.batches[b + 1] = map.batches[b] + (O)batches[b].rows.size();
+			}
+
+			std::vector<O> rowStarts(1 + rowCount, 0);
+			for (auto& batch : batches)
+			{
+				for (I r : batch.rows)
+				{
+					rowStarts[r + 1] += 1;
+				}
+			}
+			for (I i = 0; i < rowCount; i++)
+			{
+				rowStarts[i + 1] += rowStarts[i];
+			}
+
+			std::vector<I> rowsColumns(size);
+			std::vector<O> rowsSources(size);
+
+			std::vector<O> next(rowStarts.begin(), rowStarts.end() - 1);
+			for (size_t b = 0; b < batches.size(); b++)
+			{
+				auto& batch = batches[b];
+				for (size_t k = 0; k < batch.rows.size(); k++)
+				{
+					O p = next[batch.rows[k]]++;
+					rowsColumns[p] = batch.columns[k];
+					rowsSources[p] = map.batches[b] + (O)k;
+				}
+			}
+
+			std::vector<O> columnStarts(1 + columnCount, 0);
+			for (I c : rowsColumns)
+			{
+				columnStarts[c + 1] += 1;
+			}
+			for (I j = 0; j < columnCount; j++)
+			{
+				columnStarts[j + 1] += columnStarts[j];
+			}
+
+			std::vector<I> columnsRows(size);
+			map.sources.resize(size);
+
+			next.assign(columnStarts.begin(), columnStarts.end() - 1);
+			for (I i = 0; i < rowCount; i++)
+			{
+				for (O k = rowStarts[i]; k < rowStarts[i + 1]; k++)
+				{
+					O p = next[rowsColumns[k]]++;
+					columnsRows[p] = i;
+					map.sources[p] = rowsSources[k];
+				}
+			}
+
+			rowsColumns = std::vector<I>();
+			rowsSources = std::vector<O>();
+
+			map.slots.assign(1, 0);
+
+			O nnz = 0;
+			for (I j = 0; j < columnCount; j++)
+			{
+				O k = columnStarts[j];
+				columnStarts[j] = nnz;
+
+				while (k < columnStarts[j + 1])
+				{
+					I r = columnsRows[k];
+					for (k += 1; k < columnStarts[j + 1] && r == columnsRows[k]; k++)
+					{
+					}
+
+					columnsRows[nnz] = r;
+					map.slots.push_back(k);
+					nnz += 1;
+				}
+			}
+			columnStarts[columnCount] = nnz;
+
+			columnsRows.resize(nnz);
+
+			std::vector<T> contributions(size);
+			for (size_t b = 0; b < batches.size(); b++)
+			{
+				std::copy(batches[b].values.begin(), batches[b].values.end(), contributions.begin() + map.batches[b]);
+			}
+
+			auto sparse = SparseMatrix<T, I, O>::Empty(rowCount, columnCount, 0);
+			sparse.nnz = nnz;
+			sparse.columns = std::move(columnStarts);
+			sparse.columnsRows = std::move(columnsRows);
+			sparse.values.resize(nnz);
+			sparse.BuildRows();
+
+			map.AssembleTo(contributions, sparse);
+
+			return std::move(sparse);
+		}
+	};
+}
\ No newline at end of file
@@ -9,26 +9,26 @@
 
 namespace spandex::misc
 {
-	template<class T>
+	template<class T, class I = int>
 	class CommonGraph
 	{
 	public:
 		class Iterator;
 		friend class Iterator;
 
-		const static int NIL = -1;
+		const static I NIL = -1;
 
-		std::vector<int> start;
-		std::vector<int> next;
-		std::vector<int> vertices;
+		std::vector<I> start;
+		std::vector<I> next;
+		std::vector<I> vertices;
 		std::vector<T> edges;
 
-		int size;
-		int free = NIL;
+		I size;
+		I free = NIL;
 
 	public:
 
-		CommonGraph(int vertexCount, int capacity = 0)
+		CommonGraph(I vertexCount, I capacity = 0)
 		{
 			size = 0;
 			free = NIL;
@@ -40,7 +40,7 @@ namespace spandex::misc
 			edges.reserve(capacity);
 		}
 
-		void Resize(int vertexCount)
+		void Resize(I vertexCount)
 		{
 			start.resize(vertexCount);
 			Clear();
@@ -67,9 +67,9 @@ namespace spandex::misc
 			return Iterator(*this);
 		}
 
-		bool HasConnections(int vertex)
+		bool HasConnections(I vertex)
 		{
-			assert(vertex >= 0 && vertex < (int)start.size());
+			assert(vertex >= 0 && vertex < (I)start.size());
 
 			if (NIL == start[vertex])
 			{
@@ -81,9 +81,9 @@ namespace spandex::misc
 			}
 		}
 
-		bool AreConnected(const int& from, const int& to)
+		bool AreConnected(const I& from, const I& to)
 		{
-			assert(from >= 0 && from < (int)start.size());
+			assert(from >= 0 && from < (I)start.size());
 			assert(to >= 0);
 
 			if (!HasConnections(from))
@@ -91,7 +91,7 @@ namespace spandex::misc
 				return false;
 			}
 
-			for (int j = start[from]; NIL != j; j = next[j])
+			for (I j = start[from]; NIL != j; j = next[j])
 			{
 				if (to == vertices[j])
 				{
@@ -102,18 +102,18 @@ namespace spandex::misc
 			return false;
 		}
 
-		bool Equals(CommonGraph<T>& that)
+		bool Equals(CommonGraph<T, I>& that)
 		{
 			if (size != that.size)
 			{
 				return false;
 			}
 
-			const int n = (int)start.size();
-			for (int i = 0; i < n; i++)
+			const I n = (I)start.size();
+			for (I i = 0; i < n; i++)
 			{
-				int j = start[i];
-				int k = that.start[i];
+				I j = start[i];
+				I k = that.start[i];
 
 				while (NIL != j && NIL != k)
 				{
@@ -139,12 +139,12 @@ namespace spandex::misc
 			return true;
 		}
 
-		void Insert(int from, int to, const T& edge)
+		void Insert(I from, I to, const T& edge)
 		{
-			assert(from >= 0 && from < (int)start.size());
+			assert(from >= 0 && from < (I)start.size());
 			assert(to >= 0);
 
-			int n;
+			I n;
 			if (free >= 0)
 			{
 				n = free;
@@ -171,9 +171,9 @@ namespace spandex::misc
 			size += 1;
 		}
 
-		void InsertOrAssign(int from, int to, const T& edge)
+		void InsertOrAssign(I from, I to, const T& edge)
 		{
-			assert(from >= 0 && from < (int)start.size());
+			assert(from >= 0 && from < (I)start.size());
 			assert(to >= 0);
 
 			if (!AreConnected(from, to))
@@ -182,9 +182,9 @@ namespace spandex::misc
 			}
 		}
 
-		void RemoveFrom(int from, int to)
+		void RemoveFrom(I from, I to)
 		{
-			assert(from >= 0 && from < (int)start.size());
+			assert(from >= 0 && from < (I)start.size());
 			assert(to >= 0);
 
 			if (!HasConnections(from))
@@ -192,9 +192,9 @@ namespace spandex::misc
 				return;
 			}
 
-			int k = NIL;
-			int p = NIL;
-			int j = start[from];
+			I k = NIL;
+			I p = NIL;
+			I j = start[from];
 
 			while (NIL != j)
 			{
@@ -228,17 +228,17 @@ namespace spandex::misc
 			size -= 1;
 		}
 
-		void RemoveFrom(int vertex)
+		void RemoveFrom(I vertex)
 		{
-			assert(vertex >= 0 && vertex < (int)start.size());
+			assert(vertex >= 0 && vertex < (I)start.size());
 
 			if (!HasConnections(vertex))
 			{
 				return;
 			}
 
-			int n = 1;
-			int p = start[vertex];
+			I n = 1;
+			I p = start[vertex];
 
 			while (NIL != next[p])
 			{
@@ -252,18 +252,18 @@ namespace spandex::misc
 			size -= n;
 		}
 
-		bool IsLeaf(int vertex)
+		bool IsLeaf(I vertex)
 		{
-			assert(vertex >= 0 && vertex < (int)start.size());
+			assert(vertex >= 0 && vertex < (I)start.size());
 
 			if (!HasConnections(vertex))
 			{
 				return true;
 			}
 
-			int firstNeighbor = vertex;
+			I firstNeighbor = vertex;
 
-			for (int i = start[vertex]; NIL != i; i = next[i])
+			for (I i = start[vertex]; NIL != i; i = next[i])
 			{
 				if (vertex != vertices[i])
 				{
@@ -277,7 +277,7 @@ namespace spandex::misc
 				return true;
 			}
 
-			for (int i = start[vertex]; NIL != i; i = next[i])
+			for (I i = start[vertex]; NIL != i; i = next[i])
 			{
 				if (firstNeighbor != vertices[i] && vertex != vertices[i])
 				{
@@ -290,16 +290,16 @@ namespace spandex::misc
 
 		void Sort()
 		{
-			std::vector<int> sorted;
-			std::vector<int> index;
+			std::vector<I> sorted;
+			std::vector<I> index;
 
-			const int n = (int)start.size();
-			for (int i = 0; i < n; i++)
+			const I n = (I)start.size();
+			for (I i = 0; i < n; i++)
 			{
-				int count = 0;
+				I count = 0;
 				sorted.resize(0);
 				index.resize(0);
-				int j = start[i];
+				I j = start[i];
 
 				while (NIL != j)
 				{
@@ -329,16 +329,16 @@ namespace spandex::misc
 		class Iterator
 		{
 		private:
-			CommonGraph<T>& graph;
-			int next;
+			CommonGraph<T, I>& graph;
+			I next;
 
 		public:
-			Iterator(CommonGraph<T>& graph) : graph(graph)
+			Iterator(CommonGraph<T, I>& graph) : graph(graph)
 			{
 				next = NIL;
 			}
 
-			void Setup(int start)
+			void Setup(I start)
 			{
 				if (!graph.HasConnections(start))
 				{
@@ -355,28 +355,28 @@ namespace spandex::misc
 				return NIL != next;
 			}
 
-			std::pair<int, T> Next()
+			std::pair<I, T> Next()
 			{
-				int prev = next;
+				I prev = next;
 				next = graph.next[next];
-				return std::move(std::pair<int, T>(graph.vertices[prev], graph.edges[prev]));
+				return std::move(std::pair<I, T>(graph.vertices[prev], graph.edges[prev]));
 			}
 		};
 
 	private:
 		template<class Key, class Value>
-		static void KeyValueSort(std::vector<Key>& keys, std::vector<Value>& values, int begin, int end)
+		static void KeyValueSort(std::vector<Key>& keys, std::vector<Value>& values, I begin, I end)
 		{
 			assert(keys.size() == values.size());
 			assert(begin >= 0);
-			assert(end >= begin && end <= (int)keys.size());
+			assert(end >= begin && end <= (I)keys.size());
 
-			std::vector<int> indices(end - begin);
+			std::vector<I> indices(end - begin);
 			std::iota(std::begin(indices), std::end(indices), begin);
 
-			std::vector<int> sorted = indices;
+			std::vector<I> sorted = indices;
 			std::sort(std::begin(sorted), std::end(sorted),
-				[&](int a, int b) { return keys[a] < keys[b]; });
+				[&](I a, I b) { return keys[a] < keys[b]; });
 
 			reindex(values, indices, sorted);
 			reindex(keys, indices, sorted);
@@ -384,20 +384,20 @@ namespace spandex::misc
 
 		template<class Y>
 		static void reindex(std::vector<Y>& values,
-			const std::vector<int>& oldIndices, const std::vector<int>& newIndices)
+			const std::vector<I>& oldIndices, const std::vector<I>& newIndices)
 		{
 			assert(oldIndices.size() == newIndices.size());
 			assert(oldIndices.size() <= values.size());
 
-			const int n = (int)oldIndices.size();
+			const I n = (I)oldIndices.size();
 			std::vector<Y> t = values;
 
-			for (int i = 0; i < n; i++)
+			for (I i = 0; i < n; i++)
 			{
 				t[i] = values[oldIndices[i]];
 			}
 
-			for (int i = 0; i < n; i++)
+			for (I i = 0; i < n; i++)
 			{
 				values[newIndices[i]] = t[i];
 			}
@@ -5,33 +5,34 @@
 
 namespace spandex::misc
 {
-	class IntList
+	template<class I>
+	class BasicIntList
 	{
 	public:
-		const int NIL = -1;
-		const int EMPTY = -2;
-		int capacity;
-		int size;
+		const I NIL = -1;
+		const I EMPTY = -2;
+		I capacity;
+		I size;
 
 	private:
-		std::vector<int> values;
-		int ip;
+		std::vector<I> values;
+		I ip;
 
 	public:
-		IntList(int capacity) : capacity(capacity), ip(NIL), size(0)
+		BasicIntList(I capacity) : capacity(capacity), ip(NIL), size(0)
 		{
 			Resize(capacity);
 		}
 
-		void Resize(int capacity)
+		void Resize(I capacity)
 		{
 			this->values.resize(capacity, EMPTY);
 			this->capacity = capacity;
 			this->size = 0;
 			this->ip = NIL;
 
-			int i = ip;
-			int p = ip;
+			I i = ip;
+			I p = ip;
 			while (NIL != i)
 			{
 				p = i;
@@ -53,12 +54,12 @@ namespace spandex::misc
 			return 0 == size;
 		}
 
-		int GetTop() const noexcept
+		I GetTop() const noexcept
 		{
 			return ip;
 		}
 
-		int Next(int key)
+		I Next(I key)
 		{
 			if (NIL == key)
 			{
@@ -70,14 +71,14 @@ namespace spandex::misc
 			}
 		}
 
-		bool Contains(int key) const
+		bool Contains(I key) const
 		{
 			assert(key >= 0 && key < capacity);
 
 			return EMPTY != values[key];
 		}
 
-		void Push(int key)
+		void Push(I key)
 		{
 			assert(key >= 0 && key < capacity);
 
@@ -92,11 +93,11 @@ namespace spandex::misc
 			size += 1;
 		}
 
-		int Pop()
+		I Pop()
 		{
 			assert(size > 0);
 
-			const int key = ip;
+			const I key = ip;
 			ip = values[ip];
 			values[key] = EMPTY;
 			size -= 1;
@@ -104,13 +105,13 @@ namespace spandex::misc
 			return key;
 		}
 
-		std::vector<int> PopAll()
+		std::vector<I> PopAll()
 		{
-			const int n = size;
-			std::vector<int> values;
+			const I n = size;
+			std::vector<I> values;
 			values.resize(n, 0);
 
-			for (int i = 0; i < n; i++)
+			for (I i = 0; i < n; i++)
 			{
 				values[i] = Pop();
 			}
@@ -126,4 +127,5 @@ namespace spandex::misc
 			}
 		}
 	};
+	using IntList = BasicIntList<int>;
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define SPANDEX_NOMINMAX
+#endif
+#include <windows.h>
+#if defined(SPANDEX_NOMINMAX)
+#undef NOMINMAX
+#undef SPANDEX_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spandex::misc
+{
+	class MappedFile
+	{
+	private:
+		const std::byte* data;
+		size_t size;
+#if defined(_WIN32)
+		HANDLE file;
+		HANDLE mapping;
+#endif
+
+	public:
+		MappedFile(const std::string& path) : data(nullptr), size(0)
+		{
+#if defined(_WIN32)
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (INVALID_HANDLE_VALUE == file)
+			{
+				throw std::runtime_error("cannot open " + path);
+			}
+
+			LARGE_INTEGER length;
+			GetFileSizeEx(file, &length);
+			size = (size_t)length.QuadPart;
+
+			mapping = nullptr;
+			if (0 != size)
+			{
+				mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (nullptr == mapping)
+				{
+					CloseHandle(file);
+					throw std::runtime_error("cannot map " + path);
+				}
+
+				data = (const std::byte*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				if (nullptr == data)
+				{
+					CloseHandle(mapping);
+					CloseHandle(file);
+					throw std::runtime_error("cannot map " + path);
+				}
+			}
+#else
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				throw std::runtime_error("cannot open " + path);
+			}
+
+			struct stat info;
+			if (0 != fstat(fd, &info))
+			{
+				close(fd);
+				throw std::runtime_error("cannot stat " + path);
+			}
+			size = (size_t)info.st_size;
+
+			if (0 != size)
+			{
+				void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+				if (MAP_FAILED == address)
+				{
+					close(fd);
+					throw std::runtime_error("cannot map " + path);
+				}
+				data = (const std::byte*)address;
+			}
+
+			close(fd);
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+#if defined(_WIN32)
+			if (nullptr != data)
+			{
+				UnmapViewOfFile(data);
+			}
+			if (nullptr != mapping)
+			{
+				CloseHandle(mapping);
+			}
+			CloseHandle(file);
+#else
+			if (nullptr != data)
+			{
+				munmap((void*)data, size);
+			}
+#endif
+		}
+
+		const std::byte* GetData() const
+		{
+			return data;
+		}
+
+		size_t GetSize() const
+		{
+			return size;
+		}
+	};
+}
\ No newline at end of file
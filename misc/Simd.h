@@ -0,0 +1,528 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SPANDEX_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SPANDEX_AVX2
+#define SPANDEX_AVX512
+#else
+#define SPANDEX_AVX2 __attribute__((target("avx2,fma")))
+#define SPANDEX_AVX512 __attribute__((target("avx2,fma,avx512f")))
+#endif
+#endif
+
+namespace spandex::misc
+{
+	class Simd
+	{
+	public:
+		enum Level
+		{
+			Scalar, AVX2, AVX512
+		};
+
+		static Level Detect()
+		{
+#if defined(SPANDEX_X86) && defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+			{
+				return Level::Scalar;
+			}
+
+			__cpuid(info, 1);
+			bool fma = 0 != (info[2] & (1 << 12));
+			bool osxsave = 0 != (info[2] & (1 << 27));
+			if (!fma || !osxsave)
+			{
+				return Level::Scalar;
+			}
+
+			unsigned long long xcr0 = _xgetbv(0);
+			__cpuidex(info, 7, 0);
+			bool avx2 = 0 != (info[1] & (1 << 5)) && 0x6 == (xcr0 & 0x6);
+			bool avx512 = 0 != (info[1] & (1 << 16)) && 0xe6 == (xcr0 & 0xe6);
+
+			return avx512 ? Level::AVX512 : (avx2 ? Level::AVX2 : Level::Scalar);
+#elif defined(SPANDEX_X86)
+			__builtin_cpu_init();
+			if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+			{
+				return Level::Scalar;
+			}
+
+			return __builtin_cpu_supports("avx512f") ? Level::AVX512 : Level::AVX2;
+#else
+			return Level::Scalar;
+#endif
+		}
+
+		static Level GetLevel()
+		{
+			static const Level level = Detect();
+
+			return level;
+		}
+
+		static int GetLanes(int size, Level level = GetLevel())
+		{
+			switch (level)
+			{
+			case Level::AVX512:
+				return 64 / size;
+			case Level::AVX2:
+				return 32 / size;
+			default:
+				return 4;
+			}
+		}
+
+		template<class T, class I, class O>
+		static void DotTo(const O* starts, const I* indices, const T* values, const T* x, T* y, I from, I to, Level level = GetLevel())
+		{
+#if defined(SPANDEX_X86)
+			if constexpr (sizeof(I) == 4 && (std::is_same_v<T, double> || std::is_same_v<T, float>))
+			{
+				if (Level::AVX512 == level)
+				{
+					DotAVX512(starts, (const int*)indices, values, x, y, from, to);
+					return;
+				}
+				if (Level::AVX2 == level)
+				{
+					DotAVX2(starts, (const int*)indices, values, x, y, from, to);
+					return;
+				}
+			}
+#endif
+
+			for (I j = from; j < to; j++)
+			{
+				T sum = (T)0;
+				for (O k = starts[j]; k < starts[j + 1]; k++)
+				{
+					sum += values[k] * x[indices[k]];
+				}
+				y[j] = sum;
+			}
+		}
+
+		template<class T, class I, class O>
+		static void AxpyTo(const O* starts, const I* indices, const T* values, const T* x, T* y, I from, I to, Level level = GetLevel())
+		{
+#if defined(SPANDEX_X86)
+			if constexpr (sizeof(I) == 4 && (std::is_same_v<T, double> || std::is_same_v<T, float>))
+			{
+				if (Level::AVX512 == level)
+				{
+					AxpyAVX512(starts, (const int*)indices, values, x, y, from, to);
+					return;
+				}
+				if (Level::AVX2 == level)
+				{
+					AxpyAVX2(starts, (const int*)indices, values, x, y, from, to);
+					return;
+				}
+			}
+#endif
+
+			for (I j = from; j < to; j++)
+			{
+				T a = x[j];
+				for (O k = starts[j]; k < starts[j + 1]; k++)
+				{
+					y[indices[k]] += values[k] * a;
+				}
+			}
+		}
+
+		template<class T, class I, class O>
+		static void SlicedTo(const O* slices, const I* indices, const T* values, const T* x, T* y, const I* rows, I count, I chunk, I from, I to,
+			Level level = GetLevel())
+		{
+#if defined(SPANDEX_X86)
+			if constexpr (sizeof(I) == 4 && (std::is_same_v<T, double> || std::is_same_v<T, float>))
+			{
+				if (Level::AVX512 == level && 64 / sizeof(T) == chunk)
+				{
+					SlicedAVX512(slices, (const int*)indices, values, x, y, (const int*)rows, (int)count, (int)from, (int)to);
+					return;
+				}
+				if (Level::AVX2 <= level && 32 / sizeof(T) == chunk)
+				{
+					SlicedAVX2(slices, (const int*)indices, values, x, y, (const int*)rows, (int)count, (int)from, (int)to);
+					return;
+				}
+			}
+#endif
+
+			for (I s = from; s < to; s++)
+			{
+				const I* target = rows + (O)s * chunk;
+
+				for (I r = 0; r < chunk; r++)
+				{
+					if (target[r] >= count)
+					{
+						continue;
+					}
+
+					T sum = (T)0;
+					for (O k = slices[s] + r; k < slices[s + 1]; k += chunk)
+					{
+						sum += values[k] * x[indices[k]];
+					}
+					y[target[r]] = sum;
+				}
+			}
+		}
+
+#if defined(SPANDEX_X86)
+	private:
+		template<class T>
+		static void Scatter(const T* lanes, T* y, const int* rows, int count, int chunk)
+		{
+			for (int r = 0; r < chunk; r++)
+			{
+				if (rows[r] < count)
+				{
+					y[rows[r]] = lanes[r];
+				}
+			}
+		}
+
+		SPANDEX_AVX2 static __m256d GatherAVX2(const double* x, __m128i index)
+		{
+			return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, index, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+		}
+
+		SPANDEX_AVX2 static __m256 GatherAVX2(const float* x, __m256i index)
+		{
+			return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, index, _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+		}
+
+		SPANDEX_AVX512 static __m512d GatherAVX512(const double* x, __m256i index)
+		{
+			return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), (__mmask8)0xff, index, x, 8);
+		}
+
+		SPANDEX_AVX512 static __m512 GatherAVX512(const float* x, __m512i index)
+		{
+			return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), (__mmask16)0xffff, index, x, 4);
+		}
+
+		SPANDEX_AVX512 static double ReduceAVX512(__m512d sum)
+		{
+			__m256d quad = _mm256_add_pd(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), (__mmask8)0xff, sum, 0),
+				_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), (__mmask8)0xff, sum, 1));
+			__m128d half = _mm_add_pd(_mm256_castpd256_pd128(quad), _mm256_extractf128_pd(quad, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+		}
+
+		SPANDEX_AVX512 static float ReduceAVX512(__m512 sum)
+		{
+			__m512d halves = _mm512_castps_pd(sum);
+			__m256 octet = _mm256_add_ps(_mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), (__mmask8)0xff, halves, 0)),
+				_mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), (__mmask8)0xff, halves, 1)));
+			__m128 half = _mm_add_ps(_mm256_castps256_ps128(octet), _mm256_extractf128_ps(octet, 1));
+			half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+			return _mm_cvtss_f32(_mm_add_ss(half, _mm_movehdup_ps(half)));
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void DotAVX2(const O* starts, const int* indices, const double* values, const double* x, double* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m256d sum0 = _mm256_setzero_pd();
+				__m256d sum1 = _mm256_setzero_pd();
+				for (; k + 8 <= end; k += 8)
+				{
+					__m256d x0 = GatherAVX2(x, _mm_loadu_si128((const __m128i*)(indices + k)));
+					__m256d x1 = GatherAVX2(x, _mm_loadu_si128((const __m128i*)(indices + k + 4)));
+					sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), x0, sum0);
+					sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(values + k + 4), x1, sum1);
+				}
+				if (k + 4 <= end)
+				{
+					__m256d x0 = GatherAVX2(x, _mm_loadu_si128((const __m128i*)(indices + k)));
+					sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), x0, sum0);
+					k += 4;
+				}
+
+				__m256d sum = _mm256_add_pd(sum0, sum1);
+				__m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+				double total = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+				for (; k < end; k++)
+				{
+					total += values[k] * x[indices[k]];
+				}
+				y[j] = total;
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void DotAVX2(const O* starts, const int* indices, const float* values, const float* x, float* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m256 sum0 = _mm256_setzero_ps();
+				for (; k + 8 <= end; k += 8)
+				{
+					__m256 x0 = GatherAVX2(x, _mm256_loadu_si256((const __m256i*)(indices + k)));
+					sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(values + k), x0, sum0);
+				}
+
+				__m128 half = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+				half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+				float total = _mm_cvtss_f32(_mm_add_ss(half, _mm_movehdup_ps(half)));
+
+				for (; k < end; k++)
+				{
+					total += values[k] * x[indices[k]];
+				}
+				y[j] = total;
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void DotAVX512(const O* starts, const int* indices, const double* values, const double* x, double* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m512d sum0 = _mm512_setzero_pd();
+				for (; k + 8 <= end; k += 8)
+				{
+					__m512d x0 = GatherAVX512(x, _mm256_loadu_si256((const __m256i*)(indices + k)));
+					sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), x0, sum0);
+				}
+
+				double total = ReduceAVX512(sum0);
+				for (; k < end; k++)
+				{
+					total += values[k] * x[indices[k]];
+				}
+				y[j] = total;
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void DotAVX512(const O* starts, const int* indices, const float* values, const float* x, float* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m512 sum0 = _mm512_setzero_ps();
+				for (; k + 16 <= end; k += 16)
+				{
+					__m512 x0 = GatherAVX512(x, _mm512_loadu_si512(indices + k));
+					sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), x0, sum0);
+				}
+
+				float total = ReduceAVX512(sum0);
+				for (; k < end; k++)
+				{
+					total += values[k] * x[indices[k]];
+				}
+				y[j] = total;
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void AxpyAVX2(const O* starts, const int* indices, const double* values, const double* x, double* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m256d a = _mm256_set1_pd(x[j]);
+				for (; k + 4 <= end; k += 4)
+				{
+					__m256d target = GatherAVX2(y, _mm_loadu_si128((const __m128i*)(indices + k)));
+					target = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), a, target);
+
+					double lanes[4];
+					_mm256_storeu_pd(lanes, target);
+					for (int r = 0; r < 4; r++)
+					{
+						y[indices[k + r]] = lanes[r];
+					}
+				}
+
+				for (; k < end; k++)
+				{
+					y[indices[k]] += values[k] * x[j];
+				}
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void AxpyAVX2(const O* starts, const int* indices, const float* values, const float* x, float* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m256 a = _mm256_set1_ps(x[j]);
+				for (; k + 8 <= end; k += 8)
+				{
+					__m256 target = GatherAVX2(y, _mm256_loadu_si256((const __m256i*)(indices + k)));
+					target = _mm256_fmadd_ps(_mm256_loadu_ps(values + k), a, target);
+
+					float lanes[8];
+					_mm256_storeu_ps(lanes, target);
+					for (int r = 0; r < 8; r++)
+					{
+						y[indices[k + r]] = lanes[r];
+					}
+				}
+
+				for (; k < end; k++)
+				{
+					y[indices[k]] += values[k] * x[j];
+				}
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void AxpyAVX512(const O* starts, const int* indices, const double* values, const double* x, double* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m512d a = _mm512_set1_pd(x[j]);
+				for (; k + 8 <= end; k += 8)
+				{
+					__m256i index = _mm256_loadu_si256((const __m256i*)(indices + k));
+					__m512d target = GatherAVX512(y, index);
+					target = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), a, target);
+					_mm512_i32scatter_pd(y, index, target, 8);
+				}
+
+				for (; k < end; k++)
+				{
+					y[indices[k]] += values[k] * x[j];
+				}
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void AxpyAVX512(const O* starts, const int* indices, const float* values, const float* x, float* y, int from, int to)
+		{
+			for (int j = from; j < to; j++)
+			{
+				O k = starts[j];
+				O end = starts[j + 1];
+
+				__m512 a = _mm512_set1_ps(x[j]);
+				for (; k + 16 <= end; k += 16)
+				{
+					__m512i index = _mm512_loadu_si512(indices + k);
+					__m512 target = GatherAVX512(y, index);
+					target = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), a, target);
+					_mm512_i32scatter_ps(y, index, target, 4);
+				}
+
+				for (; k < end; k++)
+				{
+					y[indices[k]] += values[k] * x[j];
+				}
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void SlicedAVX2(const O* slices, const int* indices, const double* values, const double* x, double* y,
+			const int* rows, int count, int from, int to)
+		{
+			for (int s = from; s < to; s++)
+			{
+				__m256d sum = _mm256_setzero_pd();
+				for (O k = slices[s]; k < slices[s + 1]; k += 4)
+				{
+					__m256d xk = GatherAVX2(x, _mm_loadu_si128((const __m128i*)(indices + k)));
+					sum = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), xk, sum);
+				}
+				double lanes[4];
+				_mm256_storeu_pd(lanes, sum);
+				Scatter(lanes, y, rows + (O)s * 4, count, 4);
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX2 static void SlicedAVX2(const O* slices, const int* indices, const float* values, const float* x, float* y,
+			const int* rows, int count, int from, int to)
+		{
+			for (int s = from; s < to; s++)
+			{
+				__m256 sum = _mm256_setzero_ps();
+				for (O k = slices[s]; k < slices[s + 1]; k += 8)
+				{
+					__m256 xk = GatherAVX2(x, _mm256_loadu_si256((const __m256i*)(indices + k)));
+					sum = _mm256_fmadd_ps(_mm256_loadu_ps(values + k), xk, sum);
+				}
+				float lanes[8];
+				_mm256_storeu_ps(lanes, sum);
+				Scatter(lanes, y, rows + (O)s * 8, count, 8);
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void SlicedAVX512(const O* slices, const int* indices, const double* values, const double* x, double* y,
+			const int* rows, int count, int from, int to)
+		{
+			for (int s = from; s < to; s++)
+			{
+				__m512d sum = _mm512_setzero_pd();
+				for (O k = slices[s]; k < slices[s + 1]; k += 8)
+				{
+					__m512d xk = GatherAVX512(x, _mm256_loadu_si256((const __m256i*)(indices + k)));
+					sum = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), xk, sum);
+				}
+				double lanes[8];
+				_mm512_storeu_pd(lanes, sum);
+				Scatter(lanes, y, rows + (O)s * 8, count, 8);
+			}
+		}
+
+		template<class O>
+		SPANDEX_AVX512 static void SlicedAVX512(const O* slices, const int* indices, const float* values, const float* x, float* y,
+			const int* rows, int count, int from, int to)
+		{
+			for (int s = from; s < to; s++)
+			{
+				__m512 sum = _mm512_setzero_ps();
+				for (O k = slices[s]; k < slices[s + 1]; k += 16)
+				{
+					__m512 xk = GatherAVX512(x, _mm512_loadu_si512(indices + k));
+					sum = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), xk, sum);
+				}
+				float lanes[16];
+				_mm512_storeu_ps(lanes, sum);
+				Scatter(lanes, y, rows + (O)s * 16, count, 16);
+			}
+		}
+#endif
+	};
+}
\ No newline at end of file
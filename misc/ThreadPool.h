@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spandex::misc
+{
+	class ThreadPool
+	{
+	public:
+		const int size;
+
+	private:
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable started;
+		std::condition_variable finished;
+		const void* job;
+		void (*invoke)(const void*, int);
+		int generation;
+		int pending;
+		bool stopping;
+
+	public:
+		ThreadPool(int size) : size(std::max(1, size)), job(nullptr), invoke(nullptr), generation(0), pending(0), stopping(false)
+		{
+			for (int t = 1; t < this->size; t++)
+			{
+				threads.emplace_back([this, t]() { Work(t); });
+			}
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			started.notify_all();
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		template<class Func>
+		void Run(const Func& func)
+		{
+			if (1 == size)
+			{
+				func(0);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &func;
+				invoke = [](const void* job, int thread) { (*static_cast<const Func*>(job))(thread); };
+				pending = size - 1;
+				generation += 1;
+			}
+			started.notify_all();
+
+			func(0);
+
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [&]() { return 0 == pending; });
+		}
+
+		template<class Func>
+		void For(int begin, int end, const Func& func)
+		{
+			int count = end - begin;
+			if (count <= 0)
+			{
+				return;
+			}
+
+			int parts = std::min(size, count);
+			if (1 == parts)
+			{
+				func(0, begin, end);
+				return;
+			}
+
+			Run([&](int thread)
+				{
+					if (thread < parts)
+					{
+						int from = begin + (int)((long long)count * thread / parts);
+						int to = begin + (int)((long long)count * (thread + 1) / parts);
+						func(thread, from, to);
+					}
+				});
+		}
+
+	private:
+		void Work(int thread)
+		{
+			int seen = 0;
+
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					started.wait(lock, [&]() { return stopping || generation != seen; });
+					if (stopping)
+					{
+						return;
+					}
+					seen = generation;
+				}
+
+				invoke(job, thread);
+
+				std::lock_guard<std::mutex> lock(mutex);
+				pending -= 1;
+				if (0 == pending)
+				{
+					finished.notify_one();
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<long long> allocations(0);
+}
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	if (void* p = std::malloc(0 == size ? 1 : size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace spandex::test
+{
+	long long GetAllocationCount()
+	{
+		return allocations;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace spandex::test
+{
+	long long GetAllocationCount();
+}
\ No newline at end of file
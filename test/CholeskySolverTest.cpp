@@ -7,6 +7,9 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 #include <spandex/SparseMatrix.h>
 #include <spandex/CholeskySolver.h>
 
+#include "Allocations.h"
+#include "Grid.h"
+
 namespace spandex::test
 {
 	TEST_CLASS(CholeskySolver)
@@ -589,6 +592,553 @@ namespace spandex::test
 			Assert::AreEqual(0, diff, 1e-8);
 		}
 
+		TEST_METHOD(Supernodal_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			spandex::CholeskySolver<double> solver(10, 10);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.normalization = spandex::Normalization::Type::Pivots;
+
+			solver.SolveSym(a);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			auto x = solver.Solve(a, b);
+
+			solver.factorization = spandex::Factorization::Type::Supernodal;
+			auto y = solver.Solve(a, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Supernodal_2)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			spandex::CholeskySolver<double> solver(10, 10);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.normalization = spandex::Normalization::Type::NoNormalization;
+			solver.factorization = spandex::Factorization::Type::Supernodal;
+
+			solver.SolveSym(a);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			auto x = solver.Solve(a, b);
+
+			SparseArray<double> mod(10, { {1, 0.5}, {2, 0.1}, {5, 0.9} });
+
+			auto u = solver.Update(mod, 11.0);
+			u = solver.Downdate(mod, 11.0);
+
+			double diff = SquareDiff(x, u);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Parallel_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			for (auto type : { spandex::Factorization::Type::LeftLooking, spandex::Factorization::Type::Supernodal })
+			{
+				spandex::CholeskySolver<double> sequential(10, 10);
+				sequential.permutation = spandex::Permutation::Type::AMD;
+				sequential.factorization = type;
+				sequential.SolveSym(a);
+
+				spandex::CholeskySolver<double> parallel(10, 10);
+				parallel.permutation = spandex::Permutation::Type::AMD;
+				parallel.factorization = type;
+				parallel.threadCount = 4;
+				parallel.parallelColumnSize = 2;
+				parallel.SolveSym(a);
+
+				auto x = sequential.Solve(a, b);
+				auto y = parallel.Solve(a, b);
+
+				Assert::IsTrue(x == y);
+			}
+		}
+
+		TEST_METHOD(ParallelSolve_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> sequential(10, 10);
+			sequential.permutation = spandex::Permutation::Type::AMD;
+			sequential.SolveSym(a);
+
+			spandex::CholeskySolver<double> parallel(10, 10);
+			parallel.permutation = spandex::Permutation::Type::AMD;
+			parallel.threadCount = 4;
+			parallel.parallelSolveSize = 1;
+			parallel.parallelLevelSize = 2;
+			parallel.SolveSym(a);
+
+			auto x = sequential.Solve(a, b);
+			auto y = parallel.Solve(a, b);
+
+			Assert::IsTrue(x == y);
+		}
+
+		TEST_METHOD(SolveBlock_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			std::vector<double> b(30);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> solver(10, 10);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.normalization = spandex::Normalization::Type::Pivots;
+			solver.SolveSym(a);
+
+			auto x = solver.Solve(a, b, 3);
+
+			Assert::AreEqual(30, (int)x.size());
+
+			for (int t = 0; t < 3; t++)
+			{
+				std::vector<double> bt(b.begin() + t * 10, b.begin() + (t + 1) * 10);
+				auto xt = solver.Solve(a, bt);
+
+				Assert::IsTrue(std::equal(xt.begin(), xt.end(), x.begin() + t * 10));
+			}
+		}
+
+		TEST_METHOD(SolveSpan_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(10, 10);
+			expected.permutation = spandex::Permutation::Type::AMD;
+			expected.SolveSym(a);
+
+			spandex::CholeskySolver<double> solver(10, 10);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.SolveSym(a);
+
+			std::vector<double> x(10);
+			SparseArray<double> u(10, { {1, 0.5}, {2, 0.1}, {5, 0.9} });
+
+			solver.Solve(a, std::span<const double>(b), std::span<double>(x));
+			Assert::IsTrue(expected.Solve(a, b) == x);
+
+			solver.Update(u, 2.0, std::span<double>(x));
+			Assert::IsTrue(expected.Update(u, 2.0) == x);
+
+			solver.Downdate(u, 2.0, std::span<double>(x));
+			Assert::IsTrue(expected.Downdate(u, 2.0) == x);
+
+			long long before = GetAllocationCount();
+			for (int r = 0; r < 3; r++)
+			{
+				solver.Solve(a, std::span<const double>(b), std::span<double>(x));
+				solver.Update(u, 2.0, std::span<double>(x));
+				solver.Downdate(u, 2.0, std::span<double>(x));
+			}
+			Assert::AreEqual(0LL, GetAllocationCount() - before);
+		}
+
+		TEST_METHOD(SolveSpan_2)
+		{
+			auto a = Grid(20, 2);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.permutation = spandex::Permutation::Type::AMD;
+			expected.SolveSym(a);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.threadCount = 2;
+			solver.parallelColumnSize = 2;
+			solver.parallelSolveSize = 1;
+			solver.parallelLevelSize = 1;
+			solver.SolveSym(a);
+
+			std::vector<double> x(n);
+			SparseArray<double> u(n, { {1, 0.5}, {40, 0.1}, {n - 5, 0.9} });
+
+			solver.Solve(a, std::span<const double>(b), std::span<double>(x));
+			auto y = expected.Solve(a, b);
+			Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+
+			solver.Update(u, 2.0, std::span<double>(x));
+			y = expected.Update(u, 2.0);
+			Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+
+			solver.Downdate(u, 2.0, std::span<double>(x));
+			y = expected.Downdate(u, 2.0);
+			Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+
+			long long before = GetAllocationCount();
+			for (int r = 0; r < 3; r++)
+			{
+				solver.Solve(a, std::span<const double>(b), std::span<double>(x));
+				solver.Update(u, 2.0, std::span<double>(x));
+				solver.Downdate(u, 2.0, std::span<double>(x));
+			}
+			Assert::AreEqual(0LL, GetAllocationCount() - before);
+		}
+
+		TEST_METHOD(CompactStorage_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			SparseArray<double> u(10, { {1, 0.5}, {2, 0.1}, {5, 0.9} });
+
+			auto equals = [](const std::vector<double>& x, const std::vector<double>& y)
+			{
+				for (int i = 0; i < (int)x.size(); i++)
+				{
+					if (std::abs(x[i] - y[i]) > 1e-10)
+					{
+						return false;
+					}
+				}
+				return true;
+			};
+
+			for (auto type : { spandex::Factorization::Type::LeftLooking, spandex::Factorization::Type::Supernodal,
+				spandex::Factorization::Type::Skyline })
+			{
+				for (int threads : { 1, 2 })
+				{
+					spandex::CholeskySolver<double> expected(10, 10);
+					expected.permutation = spandex::Permutation::Type::AMD;
+					expected.factorization = type;
+					expected.SolveSym(a);
+
+					spandex::CholeskySolver<double> solver(10, 10);
+					solver.permutation = spandex::Permutation::Type::AMD;
+					solver.factorization = type;
+					solver.threadCount = threads;
+					solver.parallelColumnSize = 2;
+					solver.compactStorage = true;
+					solver.SolveSym(a);
+
+					Assert::IsTrue(equals(expected.Solve(a, b), solver.Solve(a, b)));
+					Assert::IsTrue(solver.GetFactor().rows.empty());
+					Assert::IsTrue(equals(expected.Update(u, 2.0), solver.Update(u, 2.0)));
+					Assert::IsTrue(equals(expected.Downdate(u, 2.0), solver.Downdate(u, 2.0)));
+					Assert::IsTrue(solver.GetFactor().rows.empty());
+				}
+			}
+		}
+
+		TEST_METHOD(CompressedIndices_1)
+		{
+			auto a = Grid(12, 2);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			std::vector<double> block(3 * n);
+			std::iota(block.begin(), block.end(), 1);
+
+			SparseArray<double> u(n, { {1, 0.5}, {20, 0.1}, {n - 5, 0.9} });
+
+			for (auto type : { spandex::Factorization::Type::LeftLooking, spandex::Factorization::Type::Supernodal,
+				spandex::Factorization::Type::Skyline })
+			{
+				for (int threads : { 1, 2 })
+				{
+					spandex::CholeskySolver<double> expected(n, n);
+					expected.permutation = spandex::Permutation::Type::AMD;
+					expected.factorization = type;
+					expected.SolveSym(a);
+
+					spandex::CholeskySolver<double> solver(n, n);
+					solver.permutation = spandex::Permutation::Type::AMD;
+					solver.factorization = type;
+					solver.threadCount = threads;
+					solver.compressedIndices = true;
+					solver.SolveSym(a);
+
+					Assert::IsTrue(solver.GetFactor().columnsRows.empty());
+
+					for (int r = 0; r < 2; r++)
+					{
+						auto x = expected.Solve(a, b);
+						auto y = solver.Solve(a, b);
+						Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+						Assert::IsTrue(solver.GetFactor().columnsRows.empty());
+					}
+
+					auto x = expected.Update(u, 2.0);
+					auto y = solver.Update(u, 2.0);
+					Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+
+					x = expected.Downdate(u, 2.0);
+					y = solver.Downdate(u, 2.0);
+					Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+
+					x = expected.Solve(a, block, 3);
+					y = solver.Solve(a, block, 3);
+					Assert::AreEqual(0, SquareDiff(x, y), 1e-8);
+					Assert::IsTrue(solver.GetFactor().columnsRows.empty());
+				}
+			}
+		}
+
+		TEST_METHOD(WideOffsets_1)
+		{
+			auto g = graph_10x10;
+			auto a = spandex::SparseMatrix<double>::FromGraph(10, 10, g);
+			auto wide = spandex::SparseMatrix<double, int, long long>::FromMatrix(a);
+
+			std::vector<double> b(10);
+			std::iota(b.begin(), b.end(), 1);
+
+			for (auto type : { spandex::Factorization::Type::LeftLooking, spandex::Factorization::Type::Supernodal })
+			{
+				spandex::CholeskySolver<double> expected(10, 10);
+				expected.permutation = spandex::Permutation::Type::AMD;
+				expected.factorization = type;
+				expected.SolveSym(a);
+
+				spandex::CholeskySolver<double, int, long long> solver(10, 10);
+				solver.permutation = spandex::Permutation::Type::AMD;
+				solver.factorization = type;
+				solver.SolveSym(wide);
+
+				Assert::IsTrue(expected.Solve(a, b) == solver.Solve(wide, b));
+			}
+		}
+
+		TEST_METHOD(WideOffsets_2)
+		{
+			misc::CommonGraph<double> g(300);
+			for (int j = 0; j < 300; j++)
+			{
+				g.Insert(0, j, 1.0);
+				if (j > 0)
+				{
+					g.Insert(j, j, 2.0);
+				}
+			}
+
+			auto a = spandex::SparseMatrix<double>::FromGraph(300, 300, g);
+			auto narrow = spandex::SparseMatrix<double, int, short>::FromMatrix(a);
+
+			spandex::CholeskySolver<double, int, short> solver(300, 300);
+
+			Assert::ExpectException<std::overflow_error>([&]() { solver.SolveSym(narrow); });
+		}
+
+		TEST_METHOD(NestedDissection_1)
+		{
+			auto a = Grid(30, 2);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.permutation = spandex::Permutation::Type::NoPermutation;
+			expected.SolveSym(a);
+			auto x = expected.Solve(a, b);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::NestedDissection;
+			solver.threadCount = 2;
+			solver.SolveSym(a);
+			auto y = solver.Solve(a, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Skyline_1)
+		{
+			int w = 20;
+			auto a = Grid(w, 2, 60);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.permutation = spandex::Permutation::Type::RCM;
+			expected.skylineWidth = n;
+			expected.SolveSym(a);
+			auto x = expected.Solve(a, b);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::RCM;
+			solver.SolveSym(a);
+			auto y = solver.Solve(a, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+
+			SparseArray<double> mod(n, { {1, 0.5}, {w + 2, 0.1}, {n - 5, 0.9} });
+
+			auto u = expected.Update(mod, 11.0);
+			u = expected.Downdate(mod, 11.0);
+
+			auto v = solver.Update(mod, 11.0);
+			v = solver.Downdate(mod, 11.0);
+
+			diff = SquareDiff(u, v);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Skyline_2)
+		{
+			auto a = Grid(12, 2);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.SolveSym(a);
+			auto x = solver.Solve(a, b);
+
+			solver.factorization = spandex::Factorization::Type::Skyline;
+			auto y = solver.Solve(a, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Skyline_3)
+		{
+			int n = 300;
+			misc::CommonGraph<double> g(n);
+			misc::CommonGraph<double> h(n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = std::max(0, i - 20); j <= std::min(n - 1, i + 20); j++)
+				{
+					g.Insert(i, j, i == j ? 50.0 : -1.0);
+					h.Insert(i, j, i == j ? 60.0 + i % 7 : 0.5);
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+			auto a2 = spandex::SparseMatrix<double>::FromGraph(n, n, h);
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.factorization = spandex::Factorization::Type::Supernodal;
+			expected.SolveSym(a2);
+			auto x = expected.Solve(a2, b);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.SolveSym(a);
+			solver.Solve(a, b);
+
+			solver.factorization = spandex::Factorization::Type::Supernodal;
+			auto y = solver.Solve(a2, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+
+			solver.factorization = spandex::Factorization::Type::LeftLooking;
+			y = solver.Solve(a2, b);
+
+			diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+		}
+
+		TEST_METHOD(Skyline_4)
+		{
+			int n = 200;
+			misc::CommonGraph<double> g(n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = std::max(0, i - 20); j <= std::min(n - 1, i + 20); j++)
+				{
+					g.Insert(i, j, i == j ? 50.0 + i % 5 : -1.0);
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			std::vector<double> block(4 * n);
+			for (int i = 0; i < 4 * n; i++)
+			{
+				block[i] = 1.0 + (i * 7) % 13;
+			}
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.skylineWidth = n;
+			expected.SolveSym(a);
+			auto x = expected.Solve(a, block, 4);
+
+			for (auto type : { spandex::Factorization::Type::LeftLooking, spandex::Factorization::Type::Skyline })
+			{
+				spandex::CholeskySolver<double> solver(n, n);
+				solver.factorization = type;
+				solver.SolveSym(a);
+				auto y = solver.Solve(a, block, 4);
+
+				double diff = SquareDiff(x, y);
+				Assert::AreEqual(0, diff, 1e-8);
+			}
+		}
+
+		TEST_METHOD(Auto_1)
+		{
+			auto a = Grid(30, 2);
+			int n = a.columnCount;
+
+			std::vector<double> b(n);
+			std::iota(b.begin(), b.end(), 1);
+
+			spandex::CholeskySolver<double> expected(n, n);
+			expected.permutation = spandex::Permutation::Type::AMD;
+			expected.SolveSym(a);
+			auto x = expected.Solve(a, b);
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::Auto;
+			solver.threadCount = 2;
+			solver.SolveSym(a);
+			auto y = solver.Solve(a, b);
+
+			double diff = SquareDiff(x, y);
+			Assert::AreEqual(0, diff, 1e-8);
+
+			auto& search = solver.GetPermutationSearch();
+			Assert::IsTrue(search.GetBest().evaluated);
+			for (auto& candidate : search.candidates)
+			{
+				Assert::IsTrue(!candidate.evaluated || search.GetBest().flops <= candidate.flops);
+			}
+		}
+
 	public:
 		CholeskySolver() : graph_3x3(3), graph_10x10(10)
 		{
@@ -0,0 +1,145 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/CommonGraph.h>
+#include <spandex/SparseMatrix.h>
+#include <spandex/CompressedPattern.h>
+#include <spandex/CholeskySolver.h>
+
+#include "Grid.h"
+
+namespace spandex::test
+{
+	TEST_CLASS(CompressedPattern)
+	{
+	public:
+
+		TEST_METHOD(FromMatrix_1)
+		{
+			misc::CommonGraph<double> g(11);
+			g.Insert(0, 0, 1);
+			g.Insert(1, 1, 2);
+			g.Insert(2, 1, 3);
+			g.Insert(2, 2, 3);
+			g.Insert(3, 3, 4);
+			g.Insert(4, 4, 5);
+			g.Insert(5, 0, 6);
+			g.Insert(5, 3, 6);
+			g.Insert(5, 5, 6);
+			g.Insert(6, 0, 7);
+			g.Insert(6, 6, 7);
+			g.Insert(7, 1, 8);
+			g.Insert(7, 4, 8);
+			g.Insert(7, 7, 8);
+			g.Insert(8, 5, 9);
+			g.Insert(8, 8, 9);
+			g.Insert(9, 2, 10);
+			g.Insert(9, 3, 10);
+			g.Insert(9, 5, 10);
+			g.Insert(9, 7, 10);
+			g.Insert(9, 9, 10);
+			g.Insert(10, 2, 11);
+			g.Insert(10, 4, 11);
+			g.Insert(10, 6, 11);
+			g.Insert(10, 7, 11);
+			g.Insert(10, 9, 11);
+			g.Insert(10, 10, 11);
+			auto ata = spandex::SparseMatrix<double>::FromGraph(11, 11, g);
+			ata.layout = spandex::Layout::LowerSymmetric;
+
+			spandex::CholeskySolver<double> solver(11, 11);
+			auto ld = solver.CholSym(ata);
+			auto cp = spandex::CompressedPattern<>::FromMatrix(ld);
+
+			Assert::AreEqual(11, cp.size);
+			Assert::IsTrue(cp.bytes.size() < ld.columnsRows.size() * sizeof(int));
+
+			for (int j = 0; j < 11; j++)
+			{
+				auto rows = cp.GetRows(j);
+				std::vector<int> expected(ld.columnsRows.begin() + ld.columns[j], ld.columnsRows.begin() + ld.columns[j + 1]);
+
+				Assert::IsTrue(expected == rows);
+			}
+		}
+
+		TEST_METHOD(Solve_1)
+		{
+			misc::CommonGraph<double> g(3);
+			g.Insert(0, 0, 6);
+			g.Insert(1, 0, 8);
+			g.Insert(1, 1, 27);
+			g.Insert(2, 0, 14);
+			g.Insert(2, 1, 27);
+			g.Insert(2, 2, 41);
+			auto ata = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+			ata.layout = spandex::Layout::LowerSymmetric;
+
+			spandex::CholeskySolver<double> solver(3, 3);
+			auto ld = solver.CholSym(ata);
+			solver.CholTo(ata, ld);
+			auto cp = spandex::CompressedPattern<>::FromMatrix(ld);
+
+			std::vector<double> b{ 1, 2, 3 };
+			std::vector<double> x(3);
+			cp.SolveLowerTo(ld, std::span<const double>(b), std::span<double>(x));
+			cp.SolveUpperTo(ld, std::span<double>(x));
+
+			for (int i = 0; i < 3; i++)
+			{
+				double sum = 0;
+				for (int k = 0; k < 3; k++)
+				{
+					sum += ata.GetColumnwise(std::max(i, k), std::min(i, k)) * x[k];
+				}
+				Assert::AreEqual(b[i], sum, 1e-10);
+			}
+		}
+
+		TEST_METHOD(Solve_2)
+		{
+			auto a = Grid(12, 2);
+			int n = a.columnCount;
+			int k = 3;
+
+			spandex::CholeskySolver<double> solver(n, n);
+			solver.permutation = spandex::Permutation::Type::AMD;
+			solver.SolveSym(a);
+
+			std::vector<double> rhs(a.rowCount, 1.0);
+			solver.Solve(a, rhs);
+
+			auto& ld = solver.GetFactor();
+			auto cp = spandex::CompressedPattern<>::FromMatrix(ld);
+
+			std::vector<double> b(n * k);
+			for (int i = 0; i < n * k; i++)
+			{
+				b[i] = 1.0 + (i * 5) % 17;
+			}
+
+			std::vector<double> x(n * k);
+			cp.SolveLowerTo(ld, std::span<const double>(b), std::span<double>(x), k);
+			cp.SolveUpperTo(ld, std::span<double>(x), k);
+
+			std::vector<double> bt(n);
+			std::vector<double> xt(n);
+			for (int t = 0; t < k; t++)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					bt[i] = b[i * k + t];
+				}
+
+				cp.SolveLowerTo(ld, std::span<const double>(bt), std::span<double>(xt));
+				cp.SolveUpperTo(ld, std::span<double>(xt));
+
+				for (int i = 0; i < n; i++)
+				{
+					Assert::AreEqual(xt[i], x[i * k + t], 1e-10 * std::abs(xt[i]));
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/CommonGraph.h>
+#include <spandex/SparseMatrix.h>
+#include <spandex/EliminationTree.h>
+#include <spandex/Permutation.h>
+
+#include <vector>
+
+namespace spandex::test
+{
+	TEST_CLASS(EliminationTree)
+	{
+		misc::CommonGraph<double> graph_11x11;
+
+	public:
+
+		TEST_METHOD(Build_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromGraph(11, 11, graph_11x11);
+			a.layout = spandex::Layout::LowerSymmetric;
+
+			auto tree = spandex::EliminationTree::Build(a);
+
+			std::vector<int> parent{ 5, 2, 7, 5, 7, 6, 8, 9, 9, 10, -1 };
+			Assert::IsTrue(parent == tree.parent);
+		}
+
+		TEST_METHOD(Postorder_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromGraph(11, 11, graph_11x11);
+			a.layout = spandex::Layout::LowerSymmetric;
+
+			auto tree = spandex::EliminationTree::Build(a);
+
+			std::vector<int> order(11, -1);
+			for (int k = 0; k < 11; k++)
+			{
+				order[tree.postorder[k]] = k;
+			}
+
+			for (int j = 0; j < 11; j++)
+			{
+				Assert::IsTrue(order[j] >= 0);
+				if (-1 != tree.parent[j])
+				{
+					Assert::IsTrue(order[j] < order[tree.parent[j]]);
+				}
+			}
+		}
+
+		TEST_METHOD(Counts_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromGraph(11, 11, graph_11x11);
+			a.layout = spandex::Layout::LowerSymmetric;
+
+			auto tree = spandex::EliminationTree::Build(a);
+
+			std::vector<int> columnCounts{ 3, 3, 4, 3, 3, 4, 4, 3, 3, 2, 1 };
+			std::vector<int> rowCounts{ 1, 1, 2, 1, 1, 3, 3, 4, 3, 7, 7 };
+
+			Assert::IsTrue(columnCounts == tree.columnCounts);
+			Assert::IsTrue(rowCounts == tree.rowCounts);
+			Assert::AreEqual(33LL, tree.GetNnz());
+		}
+
+		TEST_METHOD(BuildSqr_1)
+		{
+			misc::CommonGraph<double> g(6);
+			g.Insert(0, 0, 1);
+			g.Insert(0, 3, 1);
+			g.Insert(1, 1, 1);
+			g.Insert(1, 4, 1);
+			g.Insert(2, 0, 1);
+			g.Insert(2, 2, 1);
+			g.Insert(3, 2, 1);
+			g.Insert(3, 4, 1);
+			g.Insert(4, 3, 1);
+			g.Insert(5, 1, 1);
+			g.Insert(5, 2, 1);
+			g.Insert(5, 4, 1);
+			auto a = spandex::SparseMatrix<double>::FromGraph(6, 5, g);
+
+			for (auto type : { spandex::Permutation::Type::NoPermutation, spandex::Permutation::Type::AMD })
+			{
+				auto perm = spandex::Permutation::Build(a, type);
+				auto sqr = spandex::EliminationTree::BuildSqr(a, perm);
+
+				misc::CommonGraph<double> h(5);
+				for (int i = 0; i < 5; i++)
+				{
+					for (int j = 0; j < 5; j++)
+					{
+						double v = a.Sqr().GetColumnwise(perm.GetPermuted(i), perm.GetPermuted(j));
+						if (0 != v)
+						{
+							h.Insert(i, j, v);
+						}
+					}
+				}
+				auto ata = spandex::SparseMatrix<double>::FromGraph(5, 5, h);
+				ata.layout = spandex::Layout::LowerSymmetric;
+
+				auto tree = spandex::EliminationTree::Build(ata);
+
+				Assert::IsTrue(tree.parent == sqr.parent);
+				Assert::IsTrue(tree.columnCounts == sqr.columnCounts);
+				Assert::IsTrue(tree.rowCounts == sqr.rowCounts);
+			}
+		}
+
+	public:
+		EliminationTree() : graph_11x11(11)
+		{
+			graph_11x11.Insert(0, 0, 1);
+			graph_11x11.Insert(1, 1, 2);
+			graph_11x11.Insert(2, 1, 3);
+			graph_11x11.Insert(2, 2, 3);
+			graph_11x11.Insert(3, 3, 4);
+			graph_11x11.Insert(4, 4, 5);
+			graph_11x11.Insert(5, 0, 6);
+			graph_11x11.Insert(5, 3, 6);
+			graph_11x11.Insert(5, 5, 6);
+			graph_11x11.Insert(6, 0, 7);
+			graph_11x11.Insert(6, 6, 7);
+			graph_11x11.Insert(7, 1, 8);
+			graph_11x11.Insert(7, 4, 8);
+			graph_11x11.Insert(7, 7, 8);
+			graph_11x11.Insert(8, 5, 9);
+			graph_11x11.Insert(8, 8, 9);
+			graph_11x11.Insert(9, 2, 10);
+			graph_11x11.Insert(9, 3, 10);
+			graph_11x11.Insert(9, 5, 10);
+			graph_11x11.Insert(9, 7, 10);
+			graph_11x11.Insert(9, 9, 10);
+			graph_11x11.Insert(10, 2, 11);
+			graph_11x11.Insert(10, 4, 11);
+			graph_11x11.Insert(10, 6, 11);
+			graph_11x11.Insert(10, 7, 11);
+			graph_11x11.Insert(10, 9, 11);
+			graph_11x11.Insert(10, 10, 11);
+		}
+	};
+}
\ No newline at end of file
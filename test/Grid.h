@@ -0,0 +1,31 @@
+#pragma once
+
+#include <spandex/misc/CommonGraph.h>
+#include <spandex/SparseMatrix.h>
+
+namespace spandex::test
+{
+	inline SparseMatrix<double> Grid(int m, int dims, int layers = 0)
+	{
+		int n = 0 < layers ? layers : m;
+		for (int d = 1; d < dims; d++)
+		{
+			n *= m;
+		}
+
+		misc::CommonGraph<double> g(n);
+		for (int i = 0; i < n; i++)
+		{
+			g.Insert(i, i, 2.0 * dims + i % 3);
+			for (int d = 0, stride = 1; d < dims; d++, stride *= m)
+			{
+				if (d + 1 < dims ? (i / stride % m) + 1 < m : i + stride < n)
+				{
+					g.Insert(i, i + stride, -1.0);
+				}
+			}
+		}
+
+		return std::move(SparseMatrix<double>::FromGraph(n, n, g));
+	}
+}
\ No newline at end of file
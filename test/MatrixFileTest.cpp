@@ -0,0 +1,158 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/MatrixFile.h>
+#include <spandex/SparseMatrix.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace spandex::test
+{
+	TEST_CLASS(MatrixFile)
+	{
+	public:
+
+		TEST_METHOD(Load_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromCSR(3, 4,
+				std::vector<int>{0, 2, 3, 6},
+				std::vector<int>{0, 3, 1, 0, 2, 3},
+				std::vector<double>{1, 2, 3, 4, 5, 6});
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_load_1.bin").string();
+			spandex::MatrixFile::Save(a, path);
+
+			auto b = spandex::MatrixFile::Load<double>(path);
+			Assert::IsTrue(a.Equals(b));
+			Assert::IsTrue(a.rows == b.rows);
+			Assert::IsTrue(a.rowsColumns == b.rowsColumns);
+			Assert::IsTrue(a.positions == b.positions);
+
+			a.DropRows();
+			spandex::MatrixFile::Save(a, path);
+
+			auto c = spandex::MatrixFile::Load<double>(path);
+			Assert::IsTrue(a.Equals(c));
+			Assert::IsFalse(c.HasRows());
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Map_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromCSR(3, 3,
+				std::vector<int>{0, 1, 3, 5},
+				std::vector<int>{0, 0, 1, 1, 2},
+				std::vector<double>{4, -1, 4, -1, 4});
+			a.layout = Layout::LowerSymmetric;
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_map_1.bin").string();
+			spandex::MatrixFile::Save(a, path);
+
+			std::vector<double> y(3);
+			{
+				auto view = spandex::MatrixFile::Map<double>(path);
+				Assert::AreEqual(0, (int)((size_t)view.values.data() % spandex::MatrixFile::Alignment));
+				Assert::IsTrue(a.Equals(view.ToMatrix()));
+
+				view.MulTo(std::vector<double>{ 1, 2, 3 }, y);
+			}
+			Assert::IsTrue(std::vector<double>{ 2, 4, 10 } == y);
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Map_2)
+		{
+			auto a = spandex::SparseMatrix<float>::FromCSR(2, 2,
+				std::vector<int>{0, 1, 2},
+				std::vector<int>{0, 1},
+				std::vector<float>{1, 2});
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_map_2.bin").string();
+			spandex::MatrixFile::Save(a, path);
+
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<double>(path); });
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<float, int, long long>(path); });
+
+			{
+				spandex::MatrixFile::Header header;
+				std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+				file.read((char*)&header, sizeof(header));
+				header.layout = 5;
+				file.seekp(0);
+				file.write((const char*)&header, sizeof(header));
+			}
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<float>(path); });
+
+			spandex::MatrixFile::Save(a, path);
+			std::filesystem::resize_file(path, 200);
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<float>(path); });
+
+			{
+				std::ofstream file(path, std::ios::binary | std::ios::trunc);
+				file << "%%MatrixMarket";
+			}
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<float>(path); });
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Map_3)
+		{
+			auto a = spandex::SparseMatrix<double>::FromCSR(3, 4,
+				std::vector<int>{0, 2, 3, 6},
+				std::vector<int>{0, 3, 1, 0, 2, 3},
+				std::vector<double>{1, 2, 3, 4, 5, 6});
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_map_3.bin").string();
+
+			auto corrupt = [&](spandex::MatrixFile::Section section, int index, int value)
+			{
+				spandex::MatrixFile::Save(a, path);
+
+				spandex::MatrixFile::Header header;
+				std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+				file.read((char*)&header, sizeof(header));
+				file.seekp(header.offsets[section] + sizeof(int) * index);
+				file.write((const char*)&value, sizeof(value));
+			};
+
+			auto check = [&]()
+			{
+				Assert::IsFalse(spandex::MatrixFile::Map<double>(path).IsValid());
+				Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Map<double>(path, true); });
+				Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixFile::Load<double>(path); });
+			};
+
+			corrupt(spandex::MatrixFile::Section::Values, 0, 0);
+			Assert::IsTrue(spandex::MatrixFile::Map<double>(path, true).IsValid());
+			Assert::IsTrue(a.columnsRows == spandex::MatrixFile::Load<double>(path).columnsRows);
+
+			corrupt(spandex::MatrixFile::Section::Columns, 2, 0);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::Columns, 4, 5);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::ColumnsRows, 3, 3);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::ColumnsRows, 0, -1);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::Rows, 1, 7);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::RowsColumns, 5, 4);
+			check();
+
+			corrupt(spandex::MatrixFile::Section::Positions, 2, 6);
+			check();
+
+			std::filesystem::remove(path);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/ThreadPool.h>
+#include <spandex/MatrixMarket.h>
+#include <spandex/SparseMatrix.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace spandex::test
+{
+	TEST_CLASS(MatrixMarket)
+	{
+	public:
+
+		TEST_METHOD(Read_1)
+		{
+			auto path = Save("spandex_read_1.mtx",
+				"%%MatrixMarket matrix coordinate real general\r\n"
+				"% comment\r\n"
+				"\r\n"
+				"3 4 6\r\n"
+				"1 1 1.5\r\n"
+				"3 4 -2e1\r\n"
+				"2 2 3\r\n"
+				"1 4 +4\r\n"
+				"3 1 5.25\r\n"
+				"3 3 6\r\n");
+
+			auto e = spandex::SparseMatrix<double>::FromCSR(3, 4,
+				std::vector<int>{0, 2, 3, 6},
+				std::vector<int>{0, 3, 1, 0, 2, 3},
+				std::vector<double>{1.5, 4, 3, 5.25, 6, -20});
+
+			Assert::IsTrue(e.Equals(spandex::MatrixMarket::Read<double>(path)));
+
+			misc::ThreadPool pool(4);
+			Assert::IsTrue(e.Equals(spandex::MatrixMarket::Read<double>(path, pool)));
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Read_2)
+		{
+			auto path = Save("spandex_read_2.mtx",
+				"%%MatrixMarket matrix coordinate pattern symmetric\n"
+				"3 3 4\n"
+				"1 1\n"
+				"2 1\n"
+				"2 3\n"
+				"3 3\n");
+
+			auto e = spandex::SparseMatrix<int>::FromCSR(3, 3,
+				std::vector<int>{0, 1, 2, 4},
+				std::vector<int>{0, 0, 1, 2},
+				std::vector<int>{1, 1, 1, 1});
+
+			auto a = spandex::MatrixMarket::Read<int>(path);
+			Assert::IsTrue(e.Equals(a));
+			Assert::IsTrue(Layout::LowerSymmetric == a.layout);
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Read_3)
+		{
+			auto path = Save("spandex_read_3.mtx",
+				"%%MatrixMarket matrix coordinate real general\n"
+				"2 2 2\n"
+				"1 1 1\n");
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixMarket::Read<double>(path); });
+
+			Save("spandex_read_3.mtx",
+				"%%MatrixMarket matrix coordinate real general\n"
+				"2 2 1\n"
+				"3 1 1\n");
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixMarket::Read<double>(path); });
+
+			Save("spandex_read_3.mtx",
+				"%%MatrixMarket matrix coordinate integer general\n"
+				"2 2 1\n"
+				"1 1 x\n");
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixMarket::Read<int>(path); });
+
+			Save("spandex_read_3.mtx",
+				"%%MatrixMarket matrix array real general\n"
+				"1 1\n"
+				"1\n");
+			Assert::ExpectException<std::runtime_error>([&]() { spandex::MatrixMarket::Read<double>(path); });
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Write_1)
+		{
+			int n = 300;
+			std::vector<int> rows(1, 0);
+			std::vector<int> columns;
+			std::vector<double> values;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = i % 5; j < n; j += 7 + i % 4)
+				{
+					columns.push_back(j);
+					values.push_back(0.1 * i - 1.0 / (j + 3));
+				}
+				rows.push_back((int)columns.size());
+			}
+			auto a = spandex::SparseMatrix<double>::FromCSR(n, n, rows, columns, values);
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_write_1.mtx").string();
+
+			misc::ThreadPool pool(3);
+			spandex::MatrixMarket::Write(a, path, pool);
+			Assert::IsTrue(a.Equals(spandex::MatrixMarket::Read<double>(path, pool)));
+
+			spandex::MatrixMarket::Write(a, path);
+			Assert::IsTrue(a.Equals(spandex::MatrixMarket::Read<double>(path)));
+
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(Write_2)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(3, 3,
+				std::vector<int>{0, 3, 5, 6},
+				std::vector<int>{0, 1, 2, 1, 2, 2},
+				std::vector<int>{1, 2, 3, 4, 5, 6});
+			a.layout = Layout::UpperSymmetric;
+
+			auto path = (std::filesystem::temp_directory_path() / "spandex_write_2.mtx").string();
+			spandex::MatrixMarket::Write(a, path);
+
+			auto e = spandex::SparseMatrix<int>::FromCSR(3, 3,
+				std::vector<int>{0, 1, 3, 6},
+				std::vector<int>{0, 0, 1, 0, 1, 2},
+				std::vector<int>{1, 2, 4, 3, 5, 6});
+
+			auto b = spandex::MatrixMarket::Read<int>(path);
+			Assert::IsTrue(e.Equals(b));
+			Assert::IsTrue(Layout::LowerSymmetric == b.layout);
+
+			std::filesystem::remove(path);
+		}
+
+	private:
+		static std::string Save(const std::string& name, const std::string& content)
+		{
+			auto path = (std::filesystem::temp_directory_path() / name).string();
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file << content;
+
+			return path;
+		}
+	};
+}
\ No newline at end of file
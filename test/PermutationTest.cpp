@@ -3,10 +3,16 @@
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 #include <spandex/misc/CommonGraph.h>
+#include <spandex/misc/ThreadPool.h>
+#include <spandex/EliminationTree.h>
 #include <spandex/SparseMatrix.h>
 #include <spandex/Permutation.h>
+#include <spandex/PermutationSearch.h>
+
+#include "Grid.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <set>
 #include <vector>
 
@@ -82,5 +88,337 @@ namespace spandex::test
 			uniques = (int)(std::unique(primary.begin(), primary.end()) - primary.begin());
 			Assert::AreEqual(6, uniques);
 		}
+
+		TEST_METHOD(AMD_3)
+		{
+			auto a = Grid(20, 2);
+			int n = a.columnCount;
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::AMD);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+				Assert::AreEqual(i, pt.GetPrimary(pt.GetPermuted(i)));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+
+			auto tree = spandex::EliminationTree::BuildSqr(a, pt);
+			Assert::IsTrue(tree.GetNnz() <= 5224);
+		}
+
+		TEST_METHOD(AMD_4)
+		{
+			int n = 400;
+			misc::CommonGraph<double> g(n);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 2);
+				g.Insert(i, 7, 1);
+				if (i + 1 < n)
+				{
+					g.Insert(i, i + 1, -1);
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::AMD);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+			Assert::AreEqual(7, pt.GetPermuted(n - 1));
+		}
+
+		TEST_METHOD(COLAMD_1)
+		{
+			auto a = Grid(20, 2);
+			int n = a.columnCount;
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::COLAMD);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+				Assert::AreEqual(i, pt.GetPrimary(pt.GetPermuted(i)));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+
+			auto amd = spandex::Permutation::Build(a, spandex::Permutation::Type::AMD);
+			auto nnz = spandex::EliminationTree::BuildSqr(a, amd).GetNnz();
+			Assert::IsTrue(spandex::EliminationTree::BuildSqr(a, pt).GetNnz() <= nnz + nnz / 10);
+		}
+
+		TEST_METHOD(COLAMD_2)
+		{
+			int n = 400;
+			misc::CommonGraph<double> g(n + 1);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 2);
+				g.Insert(i, 7, 1);
+				if (i + 1 < n)
+				{
+					g.Insert(i, i + 1, -1);
+				}
+				g.Insert(n, i, 1);
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n + 1, n, g);
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::COLAMD);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+			Assert::AreEqual(7, pt.GetPermuted(n - 1));
+		}
+
+		TEST_METHOD(NestedDissection_1)
+		{
+			auto a = Grid(12, 3);
+			int n = a.columnCount;
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::NestedDissection);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+
+			misc::ThreadPool pool(3);
+			auto parallel = spandex::Permutation::Build(a, spandex::Permutation::Type::NestedDissection, pool);
+			Assert::IsTrue(pt.Equals(parallel));
+
+			auto amd = spandex::Permutation::Build(a, spandex::Permutation::Type::AMD);
+			auto tree = spandex::EliminationTree::BuildSqr(a, pt);
+			Assert::IsTrue(tree.GetNnz() < spandex::EliminationTree::BuildSqr(a, amd).GetNnz());
+		}
+
+		TEST_METHOD(NestedDissection_2)
+		{
+			int n = 1600;
+			misc::CommonGraph<double> g(n + 1);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 4);
+				g.Insert(i, (i * 7 + 1) % n, 1);
+				g.Insert(i, (i * 13 + 5) % n, 1);
+				g.Insert(i, (i * 31 + 11) % n, 1);
+			}
+			for (int j = 0; j < n; j += 2)
+			{
+				g.Insert(n, j, 1);
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n + 1, n, g);
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::NestedDissection);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+			for (int i = n / 2; i < n; i++)
+			{
+				Assert::AreEqual(0, pt.GetPermuted(i) % 2);
+			}
+
+			auto amd = spandex::Permutation::Build(a, spandex::Permutation::Type::AMD);
+			auto nnz = spandex::EliminationTree::BuildSqr(a, amd).GetNnz();
+			Assert::IsTrue(spandex::EliminationTree::BuildSqr(a, pt).GetNnz() <= nnz + nnz / 5);
+		}
+
+		TEST_METHOD(NestedDissection_3)
+		{
+			int n = 300;
+			std::vector<std::vector<int>> neighbours(n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = i + 1; j < n; j++)
+				{
+					if ((unsigned)(i * j * 2654435761u + i + j) % 10 < 4)
+					{
+						neighbours[i].push_back(j);
+						neighbours[j].push_back(i);
+					}
+				}
+			}
+			std::vector<int> starts(1, 0);
+			std::vector<int> adjacency;
+			for (auto& list : neighbours)
+			{
+				adjacency.insert(adjacency.end(), list.begin(), list.end());
+				starts.push_back((int)adjacency.size());
+			}
+
+			misc::ThreadPool pool(4);
+			auto order = spandex::NestedDissection::Order(n, starts, adjacency, pool);
+
+			std::set<int> ordered(order.begin(), order.end());
+			Assert::AreEqual(n, (int)ordered.size());
+			Assert::AreEqual(0, *ordered.begin());
+			Assert::AreEqual(n - 1, *ordered.rbegin());
+		}
+
+		TEST_METHOD(RCM_1)
+		{
+			int w = 6;
+			int h = 100;
+			int n = w * h;
+			auto id = [&](int x, int y) { return (y * w + x) * 37 % n; };
+			misc::CommonGraph<double> g(n);
+			for (int y = 0; y < h; y++)
+			{
+				for (int x = 0; x < w; x++)
+				{
+					g.Insert(id(x, y), id(x, y), 4);
+					if (x + 1 < w)
+					{
+						g.Insert(id(x, y), id(x + 1, y), -1);
+					}
+					if (y + 1 < h)
+					{
+						g.Insert(id(x, y), id(x, y + 1), -1);
+					}
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::RCM);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+				Assert::AreEqual(i, pt.GetPrimary(pt.GetPermuted(i)));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+
+			for (int j = 0; j < n; j++)
+			{
+				for (int k = a.columns[j]; k < a.columns[j + 1]; k++)
+				{
+					Assert::IsTrue(std::abs(pt.GetPrimary(a.columnsRows[k]) - pt.GetPrimary(j)) <= 2 * w);
+				}
+			}
+
+			auto natural = spandex::Permutation::Build(a, spandex::Permutation::Type::NoPermutation);
+			auto nnz = spandex::EliminationTree::BuildSqr(a, natural).GetNnz();
+			Assert::IsTrue(spandex::EliminationTree::BuildSqr(a, pt).GetNnz() * 4 < nnz);
+		}
+
+		TEST_METHOD(RCM_2)
+		{
+			int n = 31;
+			misc::CommonGraph<double> g(n);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 2);
+				if (i + 2 < n - 1)
+				{
+					g.Insert(i, i + 2, -1);
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			auto pt = spandex::Permutation::Build(a, spandex::Permutation::Type::RCM);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+				Assert::AreEqual(i, pt.GetPrimary(pt.GetPermuted(i)));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+		}
+
+		TEST_METHOD(Auto_1)
+		{
+			auto a = Grid(8, 3);
+			int n = a.columnCount;
+
+			spandex::Permutation pt;
+			auto search = spandex::PermutationSearch::Search(a, 2, 1e9, pt);
+
+			std::set<int> permuted;
+			for (int i = 0; i < n; i++)
+			{
+				permuted.insert(pt.GetPermuted(i));
+			}
+			Assert::AreEqual(n, (int)permuted.size());
+
+			Assert::AreEqual(7, (int)search.candidates.size());
+			for (auto& candidate : search.candidates)
+			{
+				Assert::IsTrue(candidate.evaluated);
+				Assert::IsTrue(search.GetBest().flops <= candidate.flops);
+			}
+			Assert::AreEqual(spandex::EliminationTree::BuildSqr(a, pt).GetNnz(), search.GetBest().nnz);
+
+			misc::ThreadPool pool(3);
+			spandex::Permutation parallel;
+			spandex::PermutationSearch::Search(a, 2, 1e9, parallel, pool);
+			Assert::IsTrue(pt.Equals(parallel));
+		}
+
+		TEST_METHOD(Auto_2)
+		{
+			int n = 50;
+			misc::CommonGraph<double> g(n);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 2);
+				g.Insert(i, (i * 7 + 3) % n, -1);
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			spandex::Permutation pt;
+			auto search = spandex::PermutationSearch::Search(a, 3, 0.0, pt);
+
+			Assert::IsTrue(search.candidates[0].evaluated);
+			Assert::IsTrue(search.candidates[1].evaluated);
+			for (size_t c = 2; c < search.candidates.size(); c++)
+			{
+				Assert::IsFalse(search.candidates[c].evaluated);
+			}
+			Assert::IsTrue(search.best < 2);
+			auto expected = spandex::Permutation::Build(a, search.GetBest().type);
+			Assert::IsTrue(pt.Equals(expected));
+		}
+
+		TEST_METHOD(Auto_3)
+		{
+			int n = 400;
+			misc::CommonGraph<double> g(n + 1);
+			for (int i = 0; i < n; i++)
+			{
+				g.Insert(i, i, 2);
+				if (i + 1 < n)
+				{
+					g.Insert(i, i + 1, -1);
+				}
+				g.Insert(n, i, 1);
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(n + 1, n, g);
+
+			spandex::Permutation pt;
+			auto search = spandex::PermutationSearch::Search(a, 2, 1e9, pt);
+
+			for (auto& candidate : search.candidates)
+			{
+				Assert::AreEqual(spandex::Permutation::Type::NestedDissection != candidate.type, candidate.evaluated);
+			}
+		}
 	};
 }
\ No newline at end of file
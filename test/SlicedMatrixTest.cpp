@@ -0,0 +1,85 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/ThreadPool.h>
+#include <spandex/SparseMatrix.h>
+#include <spandex/SlicedMatrix.h>
+
+namespace spandex::test
+{
+	TEST_CLASS(SlicedMatrix)
+	{
+	public:
+
+		TEST_METHOD(FromMatrix_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromCSR(5, 4,
+				std::vector<int>{0, 1, 4, 5, 7, 7},
+				std::vector<int>{0, 0, 1, 3, 2, 1, 3},
+				std::vector<double>{1, 2, 3, 4, 5, 6, 7});
+
+			auto sm = spandex::SlicedMatrix<double>::FromMatrix(a, 2, 1);
+
+			Assert::AreEqual(3, sm.GetSliceCount());
+			Assert::AreEqual(10, sm.GetStored());
+			Assert::AreEqual(3.0 / 7.0, sm.GetPadding(), 1e-12);
+
+			auto sorted = spandex::SlicedMatrix<double>::FromMatrix(a, 2, 4);
+
+			Assert::AreEqual(8, sorted.GetStored());
+			Assert::AreEqual(1, sorted.slicesRows[0]);
+			Assert::AreEqual(3, sorted.slicesRows[1]);
+
+			a.DropRows();
+			const auto& c = a;
+			Assert::ExpectException<std::logic_error>([&]() { spandex::SlicedMatrix<double>::FromMatrix(c, 2, 4); });
+
+			auto rebuilt = spandex::SlicedMatrix<double>::FromMatrix(a, 2, 4);
+			Assert::IsTrue(a.HasRows());
+			Assert::AreEqual(8, rebuilt.GetStored());
+		}
+
+		TEST_METHOD(Mul_1)
+		{
+			int n = 100;
+			std::vector<int> rows{ 0 };
+			std::vector<int> columns;
+			std::vector<double> values;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = i % 5; j < n; j += 3 + i % 11)
+				{
+					columns.push_back(j);
+					values.push_back(1.0 / (1 + i + j));
+				}
+				rows.push_back((int)columns.size());
+			}
+			auto a = spandex::SparseMatrix<double>::FromCSR(n, n, rows, columns, values);
+
+			std::vector<double> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = 1.0 + i % 7;
+			}
+
+			auto expected = a.Mul(x);
+
+			misc::ThreadPool pool(3);
+			for (int chunk : { 0, 1, 4, 8 })
+			{
+				auto sm = spandex::SlicedMatrix<double>::FromMatrix(a, chunk);
+				auto y = sm.Mul(x);
+
+				std::vector<double> z(n);
+				sm.MulTo(x, z, pool);
+
+				for (int i = 0; i < n; i++)
+				{
+					Assert::AreEqual(expected[i], y[i], 1e-12 * expected[i]);
+					Assert::AreEqual(y[i], z[i]);
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 #include <spandex/misc/CommonGraph.h>
+#include <spandex/misc/ThreadPool.h>
 #include <spandex/SparseMatrix.h>
 
 namespace spandex::test
@@ -35,6 +36,41 @@ namespace spandex::test
 			Assert::AreEqual(30, a.GetRowwise(2, 0));
 		}
 
+		TEST_METHOD(FromCSR_2)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(3, 4,
+				std::vector<int>{0, 4, 7, 11},
+				std::vector<int>{3, 1, 0, 2, 3, 0, 1, 2, 1, 3, 0},
+				std::vector<int>{13, 11, 10, 12, 23, 20, 21, 32, 31, 33, 30});
+
+			Assert::IsTrue(std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3} == a.rowsColumns);
+			Assert::IsTrue(std::vector<int>{0, 1, 2, 0, 1, 2, 0, 2, 0, 1, 2} == a.columnsRows);
+			Assert::AreEqual(32, a.GetRowwise(2, 2));
+			Assert::AreEqual(23, a.GetColumnwise(1, 3));
+
+			int n = 3000;
+			std::vector<int> rows{ 0 };
+			std::vector<int> columns;
+			std::vector<int> values;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = (7 * i) % 5; j < n; j += 97 + i % 13)
+				{
+					columns.push_back(n - 1 - j);
+					values.push_back(i + j);
+				}
+				rows.push_back((int)columns.size());
+			}
+
+			misc::ThreadPool pool(3);
+			auto b = spandex::SparseMatrix<int>::FromCSR(n, n, rows, columns, values);
+			auto c = spandex::SparseMatrix<int>::FromCSR(n, n, rows, columns, values, pool);
+
+			Assert::IsTrue(b.Equals(c));
+			Assert::IsTrue(b.rows == c.rows);
+			Assert::IsTrue(b.rowsColumns == c.rowsColumns);
+		}
+
 		TEST_METHOD(FromGraph_1)
 		{
 			auto a = spandex::SparseMatrix<int>::FromCSR(3, 4,
@@ -61,6 +97,24 @@ namespace spandex::test
 			Assert::IsTrue(b.Equals(a));
 		}
 
+		TEST_METHOD(FromMatrix_1)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(3, 4,
+				std::vector<int>{0, 4, 7, 11},
+				std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3},
+				std::vector<int>{10, 11, 12, 13, 20, 21, 23, 30, 31, 32, 33});
+
+			auto b = spandex::SparseMatrix<int, int, long long>::FromMatrix(a);
+
+			Assert::IsTrue(11LL == b.nnz);
+			Assert::IsTrue(11LL == b.columns.back());
+			Assert::AreEqual(23, b.GetRowwise(1, 3));
+
+			auto c = spandex::SparseMatrix<int>::FromMatrix(b);
+
+			Assert::IsTrue(a.Equals(c));
+		}
+
 		TEST_METHOD(Transpose_1)
 		{
 			auto a = spandex::SparseMatrix<int>::FromCSR(3, 4,
@@ -77,6 +131,78 @@ namespace spandex::test
 			Assert::IsFalse(a.Equals(at));
 		}
 
+		TEST_METHOD(Sort_1)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(3, 4,
+				std::vector<int>{0, 4, 7, 11},
+				std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3},
+				std::vector<int>{10, 11, 12, 13, 20, 21, 23, 30, 31, 32, 33});
+
+			auto b = a;
+			std::swap(b.columnsRows[0], b.columnsRows[2]);
+			std::swap(b.values[0], b.values[2]);
+			std::swap(b.columnsRows[3], b.columnsRows[4]);
+			std::swap(b.values[3], b.values[4]);
+			b.DropRows();
+
+			b.Sort();
+
+			Assert::IsTrue(a.Equals(b));
+			Assert::IsTrue(a.rows == b.rows);
+			Assert::IsTrue(a.rowsColumns == b.rowsColumns);
+		}
+
+		TEST_METHOD(DropRows_1)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(4, 4,
+				std::vector<int>{0, 4, 7, 11, 11},
+				std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3},
+				std::vector<int>{10, 11, 12, 13, 20, 21, 23, 30, 31, 32, 33});
+
+			auto b = a;
+			b.DropRows();
+
+			Assert::IsFalse(b.HasRows());
+			Assert::AreEqual(0, (int)b.positions.size());
+			Assert::AreEqual(23, b.GetColumnwise(1, 3));
+
+			b.BuildRows();
+
+			Assert::IsTrue(b.HasRows());
+			Assert::IsTrue(a.rows == b.rows);
+			Assert::IsTrue(a.rowsColumns == b.rowsColumns);
+			Assert::IsTrue(a.Equals(b));
+
+			b.DropRows();
+			b.SetRowwise(2, 1, 41);
+
+			Assert::IsTrue(b.HasRows());
+			Assert::AreEqual(41, b.GetColumnwise(2, 1));
+		}
+
+		TEST_METHOD(DropRows_2)
+		{
+			auto a = spandex::SparseMatrix<int>::FromCSR(4, 4,
+				std::vector<int>{0, 4, 7, 11, 11},
+				std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3},
+				std::vector<int>{10, 11, 12, 13, 20, 21, 23, 30, 31, 32, 33});
+			a.DropRows();
+
+			const auto& c = a;
+			Assert::ExpectException<std::logic_error>([&]() { c.GetRow(1); });
+			Assert::ExpectException<std::logic_error>([&]() { c.GetRowwise(1, 3); });
+
+			Assert::AreEqual(23, a.GetRowwise(1, 3));
+			Assert::IsTrue(a.HasRows());
+
+			a.DropRows();
+			auto row = a.GetRow(2);
+
+			Assert::IsTrue(a.HasRows());
+			Assert::AreEqual(4, row.nnz);
+			Assert::AreEqual(32, c.GetRowwise(2, 2));
+		}
+
 		TEST_METHOD(GetRow_1)
 		{
 			auto a = spandex::SparseMatrix<int>::FromCSR(4, 4,
@@ -404,6 +530,315 @@ namespace spandex::test
 			Assert::IsTrue(e.Equals(c));
 		}
 
+		TEST_METHOD(Mul_4)
+		{
+			auto build = [](int m, int n, int seed)
+			{
+				std::vector<int> rows{ 0 };
+				std::vector<int> columns;
+				std::vector<double> values;
+				for (int i = 0; i < m; i++)
+				{
+					int step = (0 == i % 17) ? 1 : 2 + (i * seed) % 13;
+					for (int j = (i + seed) % step; j < n; j += step)
+					{
+						columns.push_back(j);
+						values.push_back(1.0 / (seed + i + 3 * j));
+					}
+					rows.push_back((int)columns.size());
+				}
+				return spandex::SparseMatrix<double>::FromCSR(m, n, rows, columns, values);
+			};
+
+			auto a = build(120, 90, 3);
+			auto b = build(90, 70, 5);
+
+			auto expected = a.Mul(b);
+
+			for (int threads : { 1, 3 })
+			{
+				misc::ThreadPool pool(threads);
+				auto c = a.Mul(b, pool);
+
+				Assert::IsTrue(expected.Equals(c));
+				Assert::IsTrue(expected.rows == c.rows);
+				Assert::IsTrue(expected.rowsColumns == c.rowsColumns);
+			}
+		}
+
+		TEST_METHOD(Mul_5)
+		{
+			misc::CommonGraph<double> g(4);
+			g.Insert(0, 0, 2.0);
+			g.Insert(1, 1, 3.0);
+			g.Insert(2, 0, -1.0);
+			g.Insert(3, 2, 4.0);
+			auto a = spandex::SparseMatrix<double>::FromGraph(4, 3, g);
+
+			g.Clear();
+			g.Insert(0, 0, 1.0);
+			g.Insert(1, 1, 2.0);
+			g.Insert(2, 1, 5.0);
+			auto b = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+
+			auto expected = a.Mul(b);
+
+			for (int threads : { 1, 3 })
+			{
+				misc::ThreadPool pool(threads);
+				auto c = a.Mul(b, pool);
+
+				Assert::AreEqual(0, c.columns[3] - c.columns[2]);
+				Assert::IsTrue(expected.Equals(c));
+			}
+		}
+
+		TEST_METHOD(Mul_6)
+		{
+			misc::CommonGraph<double> g(3);
+			g.Insert(0, 0, 2.0);
+			g.Insert(2, 0, 3.0);
+			auto a = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+
+			g.Clear();
+			g.Insert(1, 0, 1.0);
+			g.Insert(2, 2, 4.0);
+			auto b = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+
+			for (int threads : { 1, 3 })
+			{
+				misc::ThreadPool pool(threads);
+				auto c = a.Mul(b, pool);
+
+				Assert::AreEqual(3, c.rowCount);
+				Assert::AreEqual(3, c.columnCount);
+				Assert::AreEqual(0, c.nnz);
+				Assert::IsTrue(c.columnsRows.empty());
+				Assert::IsTrue(c.values.empty());
+			}
+		}
+
+		TEST_METHOD(MulVector_1)
+		{
+			auto a = spandex::SparseMatrix<double>::FromCSR(3, 4,
+				std::vector<int>{0, 2, 5, 6},
+				std::vector<int>{0, 3, 0, 1, 2, 3},
+				std::vector<double>{1, 2, 3, 4, 5, 6});
+
+			auto y = a.Mul(std::vector<double>{ 1, 2, 3, 4 });
+
+			Assert::AreEqual(9.0, y[0]);
+			Assert::AreEqual(26.0, y[1]);
+			Assert::AreEqual(24.0, y[2]);
+
+			auto z = a.MulTranspose(std::vector<double>{ 1, 2, 3 });
+
+			Assert::AreEqual(7.0, z[0]);
+			Assert::AreEqual(8.0, z[1]);
+			Assert::AreEqual(10.0, z[2]);
+			Assert::AreEqual(20.0, z[3]);
+		}
+
+		TEST_METHOD(MulVector_2)
+		{
+			int n = 200;
+			std::vector<int> rows{ 0 };
+			std::vector<int> columns;
+			std::vector<double> values;
+			for (int i = 0; i < n; i++)
+			{
+				int step = (0 == i % 50) ? 1 : 37;
+				for (int j = i % 3; j < n; j += step)
+				{
+					columns.push_back(j);
+					values.push_back(1.0 / (1 + i + j));
+				}
+				rows.push_back((int)columns.size());
+			}
+			auto a = spandex::SparseMatrix<double>::FromCSR(n, n, rows, columns, values);
+
+			std::vector<double> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = 1.0 + i % 7;
+			}
+
+			misc::ThreadPool pool(4);
+
+			auto y = a.Mul(x);
+			std::vector<double> z(n), w(n);
+			a.MulTo(x, z, pool);
+			a.MulTo(x, w, pool);
+
+			for (int i = 0; i < n; i++)
+			{
+				Assert::AreEqual(y[i], z[i], 1e-12 * std::abs(y[i]));
+				Assert::AreEqual(z[i], w[i]);
+			}
+
+			y = a.MulTranspose(x);
+			a.MulTransposeTo(x, z, pool);
+
+			for (int i = 0; i < n; i++)
+			{
+				Assert::AreEqual(y[i], z[i], 1e-12 * std::abs(y[i]));
+			}
+		}
+
+		TEST_METHOD(MulVector_3)
+		{
+			misc::CommonGraph<double> g(3);
+			g.Insert(0, 0, 6);
+			g.Insert(1, 0, 8);
+			g.Insert(1, 1, 27);
+			g.Insert(2, 0, 14);
+			g.Insert(2, 1, 27);
+			g.Insert(2, 2, 41);
+			auto a = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+			a.layout = spandex::Layout::LowerSymmetric;
+
+			auto y = a.Mul(std::vector<double>{ 1, 2, 3 });
+
+			Assert::AreEqual(64.0, y[0]);
+			Assert::AreEqual(143.0, y[1]);
+			Assert::AreEqual(191.0, y[2]);
+		}
+
+		TEST_METHOD(MulVector_4)
+		{
+			int n = 60;
+			std::vector<int> lowerRows{ 0 }, fullRows{ 0 };
+			std::vector<int> lowerColumns, fullColumns;
+			std::vector<double> lowerValues, fullValues;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < n; j++)
+				{
+					if (i != j && 0 != (i * j) % (3 + (i + j) % 5))
+					{
+						continue;
+					}
+
+					double value = 1.0 / (1 + i + j);
+					fullColumns.push_back(j);
+					fullValues.push_back(value);
+					if (j <= i)
+					{
+						lowerColumns.push_back(j);
+						lowerValues.push_back(value);
+					}
+				}
+				lowerRows.push_back((int)lowerColumns.size());
+				fullRows.push_back((int)fullColumns.size());
+			}
+			auto lower = spandex::SparseMatrix<double>::FromCSR(n, n, lowerRows, lowerColumns, lowerValues);
+			lower.layout = spandex::Layout::LowerSymmetric;
+			auto full = spandex::SparseMatrix<double>::FromCSR(n, n, fullRows, fullColumns, fullValues);
+
+			std::vector<double> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = 1.0 + i % 7;
+			}
+
+			misc::ThreadPool pool(3);
+
+			auto expected = full.Mul(x);
+			auto y = lower.Mul(x);
+			std::vector<double> z(n);
+			lower.MulTo(x, z, pool);
+
+			for (int i = 0; i < n; i++)
+			{
+				Assert::AreEqual(expected[i], y[i], 1e-12 * expected[i]);
+				Assert::AreEqual(expected[i], z[i], 1e-12 * expected[i]);
+			}
+		}
+
+		TEST_METHOD(MulVector_5)
+		{
+			int m = 300;
+			int n = 200;
+			misc::CommonGraph<double> g(m);
+			for (int i = 0; i < m; i++)
+			{
+				int step = (0 == i % 60) ? 1 : 37;
+				for (int j = i % 5; j < n; j += step)
+				{
+					g.Insert(i, j, 1.0 / (1 + i + j));
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(m, n, g);
+
+			std::vector<double> x(n);
+			for (int j = 0; j < n; j++)
+			{
+				x[j] = 1.0 + j % 7;
+			}
+
+			misc::ThreadPool pool(4);
+
+			auto y = a.Mul(x);
+			for (bool rows : { true, false })
+			{
+				if (!rows)
+				{
+					a.DropRows();
+				}
+
+				std::vector<double> z(m), w(m);
+				a.MulTo(x, z, pool);
+				a.MulTo(x, w, pool);
+
+				Assert::AreEqual(rows, a.HasRows());
+				for (int i = 0; i < m; i++)
+				{
+					Assert::AreEqual(y[i], z[i], 1e-12 * std::abs(y[i]));
+					Assert::AreEqual(z[i], w[i]);
+				}
+			}
+		}
+		TEST_METHOD(MulVector_6)
+		{
+			int m = 1000;
+			int n = 3000;
+			misc::CommonGraph<double> g(m);
+			for (int i = 0; i < m; i++)
+			{
+				int step = (0 == i % 250) ? 1 : 433;
+				for (int j = (i * 7) % step; j < n; j += step)
+				{
+					g.Insert(i, j, 1.0 + (i + 2 * j) % 11);
+				}
+			}
+			auto a = spandex::SparseMatrix<double>::FromGraph(m, n, g);
+			Assert::AreEqual(a.nnz, (int)a.rowsValues.size());
+
+			std::vector<double> x(n);
+			for (int j = 0; j < n; j++)
+			{
+				x[j] = 1.0 + j % 5;
+			}
+
+			for (int threads : { 3, 8 })
+			{
+				misc::ThreadPool pool(threads);
+
+				a.SetColumnwise(250, 17, 100.0 + threads);
+				a.SetRowwise(3, a.rowsColumns[a.rows[3]], -1.0 * threads);
+
+				auto y = a.Mul(x);
+				std::vector<double> z(m);
+				a.MulTo(x, z, pool);
+
+				for (int i = 0; i < m; i++)
+				{
+					Assert::AreEqual(y[i], z[i], 1e-12 * std::abs(y[i]));
+				}
+			}
+		}
+
+
 		TEST_METHOD(Sqr_1)
 		{
 			misc::CommonGraph<int> g(3);
@@ -0,0 +1,123 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/CommonGraph.h>
+#include <spandex/SparseMatrix.h>
+#include <spandex/SupernodalMatrix.h>
+#include <spandex/CholeskySolver.h>
+
+namespace spandex::test
+{
+	TEST_CLASS(SupernodalMatrix)
+	{
+	public:
+
+		TEST_METHOD(FromPattern_1)
+		{
+			misc::CommonGraph<double> g(3);
+			g.Insert(0, 0, 6);
+			g.Insert(1, 0, 8);
+			g.Insert(1, 1, 27);
+			g.Insert(2, 0, 14);
+			g.Insert(2, 1, 27);
+			g.Insert(2, 2, 41);
+			auto ata = spandex::SparseMatrix<double>::FromGraph(3, 3, g);
+			ata.layout = spandex::Layout::LowerSymmetric;
+
+			spandex::CholeskySolver<double> solver(3, 3);
+			auto ld = solver.CholSym(ata);
+			auto sm = spandex::SupernodalMatrix<double>::FromPattern(ld);
+
+			Assert::AreEqual(1, sm.count);
+			Assert::AreEqual(3, sm.GetWidth(0));
+			Assert::AreEqual(3, sm.GetHeight(0));
+			Assert::AreEqual(-1, sm.GetParent(0));
+		}
+
+		TEST_METHOD(FromPattern_2)
+		{
+			misc::CommonGraph<double> g(11);
+			g.Insert(0, 0, 1);
+			g.Insert(1, 1, 2);
+			g.Insert(2, 1, 3);
+			g.Insert(2, 2, 3);
+			g.Insert(3, 3, 4);
+			g.Insert(4, 4, 5);
+			g.Insert(5, 0, 6);
+			g.Insert(5, 3, 6);
+			g.Insert(5, 5, 6);
+			g.Insert(6, 0, 7);
+			g.Insert(6, 6, 7);
+			g.Insert(7, 1, 8);
+			g.Insert(7, 4, 8);
+			g.Insert(7, 7, 8);
+			g.Insert(8, 5, 9);
+			g.Insert(8, 8, 9);
+			g.Insert(9, 2, 10);
+			g.Insert(9, 3, 10);
+			g.Insert(9, 5, 10);
+			g.Insert(9, 7, 10);
+			g.Insert(9, 9, 10);
+			g.Insert(10, 2, 11);
+			g.Insert(10, 4, 11);
+			g.Insert(10, 6, 11);
+			g.Insert(10, 7, 11);
+			g.Insert(10, 9, 11);
+			g.Insert(10, 10, 11);
+			auto ata = spandex::SparseMatrix<double>::FromGraph(11, 11, g);
+			ata.layout = spandex::Layout::LowerSymmetric;
+
+			spandex::CholeskySolver<double> solver(11, 11);
+			auto ld = solver.CholSym(ata);
+
+			auto fundamental = spandex::SupernodalMatrix<double>::FromPattern(ld, 0.0, 0);
+			Assert::AreEqual(9, fundamental.count);
+			Assert::AreEqual(3, fundamental.GetWidth(8));
+			Assert::AreEqual(11, fundamental.supernodes[fundamental.count]);
+
+			auto relaxed = spandex::SupernodalMatrix<double>::FromPattern(ld);
+			Assert::IsTrue(relaxed.count < fundamental.count);
+
+			for (int j = 0; j < 11; j++)
+			{
+				int s = relaxed.columnsSupernodes[j];
+				Assert::IsTrue(relaxed.supernodes[s] <= j && j < relaxed.supernodes[s + 1]);
+			}
+		}
+
+		TEST_METHOD(CholTo_1)
+		{
+			misc::CommonGraph<double> g(5);
+			g.Insert(0, 0, 0.454154210872255);
+			g.Insert(1, 0, 0.493313382040145);
+			g.Insert(1, 1, 0.673117517240105);
+			g.Insert(2, 0, 0);
+			g.Insert(2, 1, 0.267770063806461);
+			g.Insert(2, 2, 0.753202118586013);
+			g.Insert(3, 0, 0.597779567627811);
+			g.Insert(3, 1, 0.650049443659237);
+			g.Insert(3, 2, 0.337426886372401);
+			g.Insert(3, 3, 1.72955430012221);
+			g.Insert(4, 0, 0.0939734363675742);
+			g.Insert(4, 1, 0.0200830025404996);
+			g.Insert(4, 2, 0);
+			g.Insert(4, 3, 0.25140727798654);
+			g.Insert(4, 4, 0.527264476708613);
+			auto ata = spandex::SparseMatrix<double>::FromGraph(5, 5, g);
+			ata.layout = spandex::Layout::LowerSymmetric;
+
+			spandex::CholeskySolver<double> solver(5, 5);
+			auto e = solver.CholSym(ata);
+			solver.CholTo(ata, e);
+
+			auto ld = solver.CholSym(ata);
+			auto sm = spandex::SupernodalMatrix<double>::FromPattern(ld);
+			sm.CholTo(ata, solver.tolerance);
+			sm.CopyTo(ld);
+
+			Assert::IsTrue(ld.Equals(e,
+				[](double x, double y) { return std::abs(x - y) < 1e-12; }));
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <spandex/misc/CommonGraph.h>
+#include <spandex/misc/ThreadPool.h>
+#include <spandex/SparseMatrix.h>
+#include <spandex/TripletMatrix.h>
+
+namespace spandex::test
+{
+	TEST_CLASS(TripletMatrix)
+	{
+	public:
+
+		TEST_METHOD(ToMatrix_1)
+		{
+			spandex::TripletMatrix<int> t(3, 4);
+			t.Insert(2, 3, 33);
+			t.Insert(0, 0, 10);
+			t.Insert(1, 3, 20);
+			t.Insert(0, 1, 11);
+			t.Insert(1, 3, 3);
+			t.Insert(std::vector<int>{ 1, 2, 0, 2, 0, 1, 2 }, std::vector<int>{ 0, 1, 2, 0, 3, 1, 2 }, std::vector<int>{ 20, 31, 12, 30, 13, 21, 32 });
+
+			Assert::AreEqual(12, t.GetSize());
+
+			auto a = t.ToMatrix();
+			auto e = spandex::SparseMatrix<int>::FromCSR(3, 4,
+				std::vector<int>{0, 4, 7, 11},
+				std::vector<int>{0, 1, 2, 3, 0, 1, 3, 0, 1, 2, 3},
+				std::vector<int>{10, 11, 12, 13, 20, 21, 23, 30, 31, 32, 33});
+
+			Assert::IsTrue(e.Equals(a));
+			Assert::IsTrue(e.rows == a.rows);
+			Assert::IsTrue(e.rowsColumns == a.rowsColumns);
+		}
+
+		TEST_METHOD(ToMatrix_2)
+		{
+			int n = 200;
+			misc::ThreadPool pool(4);
+			spandex::TripletMatrix<double> t(n, n, pool.size);
+
+			pool.For(0, n, [&](int thread, int from, int to)
+				{
+					for (int i = from; i < to; i++)
+					{
+						for (int j = i % 7; j < n; j += 5 + i % 3)
+						{
+							t.Insert(i, j, 0.5, thread);
+							t.Insert(i, j, 0.25, thread);
+						}
+					}
+				});
+
+			misc::CommonGraph<double> g(n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = i % 7; j < n; j += 5 + i % 3)
+				{
+					g.Insert(i, j, 0.75);
+				}
+			}
+			auto e = spandex::SparseMatrix<double>::FromGraph(n, n, g);
+
+			Assert::IsTrue(e.Equals(t.ToMatrix()));
+		}
+
+		TEST_METHOD(Assemble_1)
+		{
+			int n = 50;
+			spandex::TripletMatrix<double> t(n, n, 2);
+			for (int e = 0; e < n - 1; e++)
+			{
+				int thread = e % 2;
+				t.Insert(e, e, 1.0, thread);
+				t.Insert(e, e + 1, -1.0, thread);
+				t.Insert(e + 1, e, -1.0, thread);
+				t.Insert(e + 1, e + 1, 1.0, thread);
+			}
+
+			spandex::AssemblyMap<double> map;
+			auto a = t.ToMatrix(map);
+
+			Assert::AreEqual(3 * n - 2, a.nnz);
+			Assert::AreEqual(4 * (n - 1), map.GetSize());
+			Assert::AreEqual(2.0, a.GetColumnwise(1, 1));
+
+			std::vector<double> contributions(map.GetSize());
+			for (int thread = 0; thread < 2; thread++)
+			{
+				auto& batch = t.batches[thread];
+				for (int k = 0; k < (int)batch.values.size(); k++)
+				{
+					batch.values[k] *= 0.5 + k % 3;
+					contributions[map.GetOffset(thread) + k] = batch.values[k];
+				}
+			}
+
+			misc::ThreadPool pool(3);
+			map.AssembleTo(contributions, a, pool);
+
+			Assert::IsTrue(t.ToMatrix().Equals(a));
+		}
+	};
+}
\ No newline at end of file
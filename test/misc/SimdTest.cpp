@@ -0,0 +1,182 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <spandex/misc/Simd.h>
+
+namespace spandex::misc::test
+{
+	TEST_CLASS(Simd)
+	{
+	public:
+
+		TEST_METHOD(DotTo_1)
+		{
+			CheckDot<double>(1e-12);
+		}
+
+		TEST_METHOD(DotTo_2)
+		{
+			CheckDot<float>(1e-5f);
+		}
+
+		TEST_METHOD(AxpyTo_1)
+		{
+			CheckAxpy<double>(1e-12);
+		}
+
+		TEST_METHOD(AxpyTo_2)
+		{
+			CheckAxpy<float>(1e-5f);
+		}
+
+		TEST_METHOD(SlicedTo_1)
+		{
+			CheckSliced<double>(1e-12);
+		}
+
+		TEST_METHOD(SlicedTo_2)
+		{
+			CheckSliced<float>(1e-5f);
+		}
+
+	private:
+		template<class T>
+		static void Build(int n, std::vector<int>& starts, std::vector<int>& indices, std::vector<T>& values, std::vector<T>& x)
+		{
+			starts.assign(1, 0);
+			indices.clear();
+			values.clear();
+			for (int j = 0; j < n; j++)
+			{
+				int length = (j * 7) % 37;
+				for (int t = 0; t < length; t++)
+				{
+					indices.push_back((j + 3 * t) % n);
+					values.push_back((T)1 / (T)(1 + j + t));
+				}
+				starts.push_back((int)indices.size());
+			}
+
+			x.resize(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = (T)0.5 + (T)(i % 11);
+			}
+		}
+
+		template<class T>
+		static void CheckDot(T tolerance)
+		{
+			int n = 61;
+			std::vector<int> starts, indices;
+			std::vector<T> values, x;
+			Build(n, starts, indices, values, x);
+
+			std::vector<T> expected(n);
+			misc::Simd::DotTo(starts.data(), indices.data(), values.data(), x.data(), expected.data(), 0, n, misc::Simd::Level::Scalar);
+
+			for (int level = misc::Simd::Level::Scalar; level <= misc::Simd::GetLevel(); level++)
+			{
+				std::vector<T> actual(n);
+				misc::Simd::DotTo(starts.data(), indices.data(), values.data(), x.data(), actual.data(), 0, n, (misc::Simd::Level)level);
+
+				for (int j = 0; j < n; j++)
+				{
+					Assert::AreEqual(expected[j], actual[j], tolerance * std::abs(expected[j]));
+				}
+			}
+		}
+
+		template<class T>
+		static void CheckAxpy(T tolerance)
+		{
+			int n = 61;
+			std::vector<int> starts, indices;
+			std::vector<T> values, x;
+			Build(n, starts, indices, values, x);
+
+			std::vector<T> expected(x);
+			misc::Simd::AxpyTo(starts.data(), indices.data(), values.data(), x.data(), expected.data(), 0, n, misc::Simd::Level::Scalar);
+
+			for (int level = misc::Simd::Level::Scalar; level <= misc::Simd::GetLevel(); level++)
+			{
+				std::vector<T> actual(x);
+				misc::Simd::AxpyTo(starts.data(), indices.data(), values.data(), x.data(), actual.data(), 0, n / 2, (misc::Simd::Level)level);
+				misc::Simd::AxpyTo(starts.data(), indices.data(), values.data(), x.data(), actual.data(), n / 2, n, (misc::Simd::Level)level);
+
+				for (int i = 0; i < n; i++)
+				{
+					Assert::AreEqual(expected[i], actual[i], tolerance * std::abs(expected[i]));
+				}
+			}
+		}
+
+		template<class T>
+		static void CheckSliced(T tolerance)
+		{
+			int n = 61;
+			std::vector<T> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = (T)0.5 + (T)(i % 11);
+			}
+
+			for (int chunk : { 4, (int)(32 / sizeof(T)), (int)(64 / sizeof(T)) })
+			{
+				int count = 7;
+				std::vector<int> slices{ 0 };
+				std::vector<int> indices;
+				std::vector<T> values;
+				for (int s = 0; s < count; s++)
+				{
+					int width = (s * 3) % 5;
+					for (int k = 0; k < width * chunk; k++)
+					{
+						indices.push_back((s + 5 * k) % n);
+						values.push_back((T)1 / (T)(1 + s + k));
+					}
+					slices.push_back((int)indices.size());
+				}
+
+				int m = count * chunk - 3;
+				std::vector<int> rows(count * chunk);
+				for (int r = 0; r < count * chunk; r++)
+				{
+					rows[r] = (r * 5) % (count * chunk);
+				}
+
+				std::vector<T> expected(m, (T)-1);
+				misc::Simd::SlicedTo(slices.data(), indices.data(), values.data(), x.data(), expected.data(), rows.data(), m, chunk, 0, count,
+					misc::Simd::Level::Scalar);
+
+				for (int i = 0; i < m; i++)
+				{
+					T sum = (T)0;
+					int r = (int)(std::find(rows.begin(), rows.end(), i) - rows.begin());
+					for (int k = slices[r / chunk] + r % chunk; k < slices[r / chunk + 1]; k += chunk)
+					{
+						sum += values[k] * x[indices[k]];
+					}
+					Assert::AreEqual(sum, expected[i], tolerance * std::abs(sum));
+				}
+
+				for (int level = misc::Simd::Level::Scalar; level <= misc::Simd::GetLevel(); level++)
+				{
+					std::vector<T> actual(m, (T)-1);
+					misc::Simd::SlicedTo(slices.data(), indices.data(), values.data(), x.data(), actual.data(), rows.data(), m, chunk, 0, count,
+						(misc::Simd::Level)level);
+
+					for (int i = 0; i < m; i++)
+					{
+						Assert::AreEqual(expected[i], actual[i], tolerance * std::abs(expected[i]));
+					}
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <atomic>
+#include <vector>
+
+#include <spandex/misc/ThreadPool.h>
+
+namespace spandex::misc::test
+{
+	TEST_CLASS(ThreadPool)
+	{
+	public:
+
+		TEST_METHOD(Run_1)
+		{
+			misc::ThreadPool pool(4);
+			std::vector<int> visited(4, 0);
+
+			pool.Run([&](int thread) { visited[thread] += 1; });
+			pool.Run([&](int thread) { visited[thread] += 1; });
+
+			for (int t = 0; t < 4; t++)
+			{
+				Assert::AreEqual(2, visited[t]);
+			}
+		}
+
+		TEST_METHOD(For_1)
+		{
+			misc::ThreadPool pool(3);
+			std::vector<int> values(100, 0);
+			std::atomic<int> calls(0);
+
+			pool.For(10, 100, [&](int /*thread*/, int from, int to)
+				{
+					calls++;
+					for (int i = from; i < to; i++)
+					{
+						values[i] += 1;
+					}
+				});
+
+			Assert::AreEqual(3, calls.load());
+			for (int i = 0; i < 100; i++)
+			{
+				Assert::AreEqual(i < 10 ? 0 : 1, values[i]);
+			}
+		}
+
+		TEST_METHOD(For_2)
+		{
+			misc::ThreadPool pool(1);
+			int sum = 0;
+
+			pool.For(0, 5, [&](int /*thread*/, int from, int to)
+				{
+					for (int i = from; i < to; i++)
+					{
+						sum += i;
+					}
+				});
+
+			Assert::AreEqual(10, sum);
+		}
+	};
+}
\ No newline at end of file